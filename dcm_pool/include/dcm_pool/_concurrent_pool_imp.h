@@ -0,0 +1,451 @@
+/*!
+* \file	include\dcm_pool\_concurrent_pool_imp.h.
+*
+* \brief		Implement the ConcurrentDcmPool class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "exceptions.h"
+
+#ifndef __CONCURRENT_POOL_IMP__
+#define __CONCURRENT_POOL_IMP__
+
+namespace dcm_pool
+{
+	template <typename T, typename Allocator>
+	ConcurrentDcmPool<T, Allocator>::ConcurrentDcmPool(size_t max_size, size_t reserve, const Allocator& allocator) :
+		_objects(allocator),
+		_entries(allocator),
+		_slots(allocator),
+		_max_size(max_size ? max_size : ObjectPoolMaxIndex),
+		_defrags_count(0),
+		_used_size(0),
+		_allocated_objects_count(0)
+	{
+		// indices must fit in the holes stack
+		if (_max_size > _internal::ConcurrentFreeStack::MaxIndex)
+		{
+			_max_size = _internal::ConcurrentFreeStack::MaxIndex;
+		}
+
+		// allocate memory in advance
+		if (reserve)
+		{
+			Reserve(reserve);
+		}
+	}
+
+	template <typename T, typename Allocator>
+	ConcurrentDcmPool<T, Allocator>::~ConcurrentDcmPool()
+	{
+		Clear();
+	}
+
+	template <typename T, typename Allocator>
+	template <typename... Args>
+	typename ConcurrentDcmPool<T, Allocator>::Ptr ConcurrentDcmPool<T, Allocator>::Emplace(Args&&... args)
+	{
+		// take index and slot
+		size_t index = AllocIndex();
+		ObjectId id;
+		try
+		{
+			id = _slots.alloc(index);
+		}
+		catch (...)
+		{
+			_holes.push(index, *this);
+			throw;
+		}
+
+		// construct the object. if constructor throws, return index and slot
+		try
+		{
+			ConstructObject(index, id, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			_slots.cancel(id);
+			_holes.push(index, *this);
+			throw;
+		}
+
+		// only now make the id alive, so a thread that releases it sees everything we did
+		_allocated_objects_count.fetch_add(1, std::memory_order_relaxed);
+		_slots.publish(id);
+
+		// return pointer
+		return Ptr(this, id);
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::Release(ObjectId id)
+	{
+		if (!TryRelease(id))
+		{
+			throw AccessViolation();
+		}
+	}
+
+	template <typename T, typename Allocator>
+	bool ConcurrentDcmPool<T, Allocator>::TryRelease(ObjectId id)
+	{
+		// release the slot first. only one thread can succeed this for a given id
+		size_t index;
+		if (!_slots.release(id, index))
+		{
+			return false;
+		}
+
+		// destroy object and add its index to the holes
+		DestroyObject(index);
+		_holes.push(index, *this);
+		_allocated_objects_count.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::Reserve(size_t amount)
+	{
+		// allocate all pages up to the required amount
+		for (size_t page = 0; amount && _objects.page_begin(page) < amount; ++page)
+		{
+			size_t index = _objects.page_begin(page);
+			_objects.ensure(index);
+			_entries.ensure(index);
+		}
+	}
+
+	template <typename T, typename Allocator>
+	template <typename Callback>
+	void ConcurrentDcmPool<T, Allocator>::ForEach(Callback&& callback)
+	{
+		ForEachUsed(*this, callback);
+	}
+
+	template <typename T, typename Allocator>
+	template <typename Callback>
+	void ConcurrentDcmPool<T, Allocator>::ForEach(Callback&& callback) const
+	{
+		ForEachUsed(*this, callback);
+	}
+
+	template <typename T, typename Allocator>
+	template <typename Self, typename Callback>
+	void ConcurrentDcmPool<T, Allocator>::ForEachUsed(Self& self, Callback& callback)
+	{
+		// iterate one page at a time, so we only find the page once per page and not per object
+		size_t used_size = self._used_size.load(std::memory_order_acquire);
+		for (size_t page = 0; self._objects.page_begin(page) < used_size; ++page)
+		{
+			size_t first = self._objects.page_begin(page);
+			size_t count = std::min(self._objects.page_size(page), used_size - first);
+			auto objects = self._objects.page(page);
+			auto entries = self._entries.page(page);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (entries[i].used.load(std::memory_order_relaxed) &&
+					!_internal::invoke_iteration_callback(callback, objects[i], entries[i].id.load(std::memory_order_relaxed), self, _internal::CallbackRank<2>()))
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::Defrag()
+	{
+		// no holes? skip
+		size_t used_size = _used_size.load(std::memory_order_relaxed);
+		size_t count = _allocated_objects_count.load(std::memory_order_relaxed);
+		if (used_size == count)
+		{
+			return;
+		}
+
+		// fill every hole before 'count' with the last used object
+		size_t last = used_size;
+		for (size_t hole = 0; hole < count; ++hole)
+		{
+			// skip used objects
+			Entry& hole_entry = _entries[hole];
+			if (hole_entry.used.load(std::memory_order_relaxed))
+			{
+				continue;
+			}
+
+			// find last used object
+			do
+			{
+				--last;
+			} while (!_entries[last].used.load(std::memory_order_relaxed));
+
+			// move it into the hole
+			Entry& last_entry = _entries[last];
+			ObjectId id = last_entry.id.load(std::memory_order_relaxed);
+			MoveObject(last, hole, typename std::integral_constant<bool, IsTriviallyRelocatable<T>::value>());
+			hole_entry.id.store(id, std::memory_order_relaxed);
+			hole_entry.used.store(true, std::memory_order_relaxed);
+			last_entry.used.store(false, std::memory_order_relaxed);
+			_slots.set_index(id, hole);
+		}
+
+		// no more holes, objects are [0, count)
+		_holes.clear();
+		_used_size.store(count, std::memory_order_relaxed);
+		_defrags_count++;
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::Clear()
+	{
+		// destroy all objects
+		size_t used_size = _used_size.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < used_size; ++i)
+		{
+			Entry& entry = _entries[i];
+			if (entry.used.load(std::memory_order_relaxed))
+			{
+				_objects[i].~T();
+				entry.used.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		// reset state (slots keep their generations so old ids remain invalid)
+		_slots.clear();
+		_holes.clear();
+		_used_size.store(0, std::memory_order_relaxed);
+		_allocated_objects_count.store(0, std::memory_order_relaxed);
+		_defrags_count++;
+	}
+
+	template <typename T, typename Allocator>
+	T& ConcurrentDcmPool<T, Allocator>::_get_object(ObjectId id)
+	{
+		T* object = TryGet(id);
+		if (!object)
+		{
+			throw AccessViolation();
+		}
+		return *object;
+	}
+
+	template <typename T, typename Allocator>
+	size_t ConcurrentDcmPool<T, Allocator>::AllocIndex()
+	{
+		// fill a hole if we have one
+		size_t index = _holes.pop(*this);
+		if (index != ObjectPoolMaxIndex)
+		{
+			return index;
+		}
+
+		// take a new index at the end
+		ReserveIndices(1, index);
+		return index;
+	}
+
+	template <typename T, typename Allocator>
+	size_t ConcurrentDcmPool<T, Allocator>::ReserveIndices(size_t count, size_t& first)
+	{
+		// increase used size, without ever going beyond max size
+		size_t used_size = _used_size.load(std::memory_order_relaxed);
+		size_t reserved;
+		do
+		{
+			if (used_size >= _max_size)
+			{
+				throw ExceededPoolLimit();
+			}
+			reserved = count < _max_size - used_size ? count : _max_size - used_size;
+		} while (!_used_size.compare_exchange_weak(used_size, used_size + reserved, std::memory_order_relaxed));
+
+		// make sure all reserved indices have memory
+		for (size_t page = _objects.page_of(used_size); page <= _objects.page_of(used_size + reserved - 1); ++page)
+		{
+			_objects.ensure(_objects.page_begin(page));
+			_entries.ensure(_objects.page_begin(page));
+		}
+		first = used_size;
+		return reserved;
+	}
+
+	template <typename T, typename Allocator>
+	template <typename... Args>
+	void ConcurrentDcmPool<T, Allocator>::ConstructObject(size_t index, ObjectId id, Args&&... args)
+	{
+		::new ((void*)&_objects[index]) T(std::forward<Args>(args)...);
+		Entry& entry = _entries[index];
+		entry.id.store(id, std::memory_order_relaxed);
+		entry.used.store(true, std::memory_order_relaxed);
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::DestroyObject(size_t index)
+	{
+		_objects[index].~T();
+		_entries[index].used.store(false, std::memory_order_relaxed);
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::MoveObject(size_t from, size_t to, std::false_type)
+	{
+		T& source = _objects[from];
+		::new ((void*)&_objects[to]) T(std::move(source));
+		source.~T();
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::MoveObject(size_t from, size_t to, std::true_type)
+	{
+		std::memcpy((void*)&_objects[to], (const void*)&_objects[from], sizeof(T));
+	}
+
+	template <typename T, typename Allocator>
+	template <typename... Args>
+	typename ConcurrentDcmPool<T, Allocator>::Ptr ConcurrentDcmPool<T, Allocator>::ThreadCache::Emplace(Args&&... args)
+	{
+		// take index and slot (both owned by this cache, so nobody else touches them)
+		size_t index = AllocIndex();
+		size_t slot;
+		try
+		{
+			slot = AllocSlot();
+		}
+		catch (...)
+		{
+			_free_indices.push(index, *_pool);
+			throw;
+		}
+		ObjectId id = _pool->_slots.assign(slot, index);
+
+		// construct the object. if constructor throws, keep index and slot for next time
+		try
+		{
+			_pool->ConstructObject(index, id, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			_free_slots.push(slot, _pool->_slots);
+			_free_indices.push(index, *_pool);
+			throw;
+		}
+
+		// make the id alive
+		_objects_count_delta++;
+		_pool->_slots.publish(id);
+		return Ptr(_pool, id);
+	}
+
+	template <typename T, typename Allocator>
+	bool ConcurrentDcmPool<T, Allocator>::ThreadCache::TryRelease(ObjectId id)
+	{
+		// release the slot, but keep it for ourselves
+		size_t index;
+		if (!_pool->_slots.retire(id, index))
+		{
+			return false;
+		}
+
+		// destroy object and keep its index for our next allocations
+		_pool->DestroyObject(index);
+		_free_indices.push(index, *_pool);
+		_free_slots.push(_internal::get_id_slot(id), _pool->_slots);
+		_objects_count_delta--;
+		return true;
+	}
+
+	template <typename T, typename Allocator>
+	void ConcurrentDcmPool<T, Allocator>::ThreadCache::Synchronize()
+	{
+		// add what's left of the reserved ranges to the free lists
+		for (; _next_index < _indices_end; ++_next_index)
+		{
+			_free_indices.push(_next_index, *_pool);
+		}
+		for (; _next_slot < _slots_end; ++_next_slot)
+		{
+			_free_slots.push(_next_slot, _pool->_slots);
+		}
+
+		// return free lists to the pool (a single update for each), and update objects count
+		_free_indices.flush(_pool->_holes, *_pool);
+		_pool->_slots.return_free(_free_slots);
+		if (_objects_count_delta)
+		{
+			_pool->_allocated_objects_count.fetch_add(_objects_count_delta, std::memory_order_relaxed);
+			_objects_count_delta = 0;
+		}
+	}
+
+	template <typename T, typename Allocator>
+	size_t ConcurrentDcmPool<T, Allocator>::ThreadCache::AllocIndex()
+	{
+		// reuse our own free indices
+		size_t index = _free_indices.pop(*_pool);
+		if (index != ObjectPoolMaxIndex)
+		{
+			return index;
+		}
+
+		// take from our reserved range
+		if (_next_index < _indices_end)
+		{
+			return _next_index++;
+		}
+
+		// take all the pool's holes at once
+		index = _pool->_holes.take_all();
+		if (index != ObjectPoolMaxIndex)
+		{
+			_free_indices.take(index);
+			return _free_indices.pop(*_pool);
+		}
+
+		// reserve a new range at the end of the pool
+		size_t first;
+		_indices_end = _pool->ReserveIndices(_batch, first) + first;
+		_next_index = first + 1;
+		return first;
+	}
+
+	template <typename T, typename Allocator>
+	size_t ConcurrentDcmPool<T, Allocator>::ThreadCache::AllocSlot()
+	{
+		// reuse our own free slots
+		size_t slot = _free_slots.pop(_pool->_slots);
+		if (slot != ObjectPoolMaxIndex)
+		{
+			return slot;
+		}
+
+		// take from our reserved range
+		if (_next_slot < _slots_end)
+		{
+			return _next_slot++;
+		}
+
+		// take all the pool's free slots at once
+		slot = _pool->_slots.take_free();
+		if (slot != ObjectPoolMaxIndex)
+		{
+			_free_slots.take(slot);
+			return _free_slots.pop(_pool->_slots);
+		}
+
+		// reserve a new range of slots
+		size_t first;
+		_slots_end = _pool->_slots.reserve(_batch, first) + first;
+		_next_slot = first + 1;
+		return first;
+	}
+}
+
+#endif
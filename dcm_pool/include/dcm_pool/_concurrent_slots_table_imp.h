@@ -0,0 +1,115 @@
+/*!
+* \file	include\dcm_pool\_concurrent_slots_table_imp.h.
+*
+* \brief		Implement the ConcurrentSlotsTable class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include "exceptions.h"
+
+#ifndef __CONCURRENT_SLOTS_TABLE_IMP__
+#define __CONCURRENT_SLOTS_TABLE_IMP__
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		template <typename Allocator>
+		ObjectId ConcurrentSlotsTable<Allocator>::alloc(size_t index)
+		{
+			// reuse a free slot, or reserve a new one
+			size_t slot = _free.pop(*this);
+			if (slot == ObjectPoolMaxIndex)
+			{
+				reserve(1, slot);
+			}
+			return assign(slot, index);
+		}
+
+		template <typename Allocator>
+		ObjectId ConcurrentSlotsTable<Allocator>::assign(size_t slot_index, size_t index)
+		{
+			// set index and return id with the next (used) generation. the slot generation is only set when published
+			Slot& slot = _slots[slot_index];
+			slot.index.store(index, std::memory_order_relaxed);
+			size_t generation = (slot.generation.load(std::memory_order_relaxed) + 1) & ObjectIdSlotMask;
+			return make_object_id(slot_index, generation);
+		}
+
+		template <typename Allocator>
+		size_t ConcurrentSlotsTable<Allocator>::reserve(size_t count, size_t& first)
+		{
+			// increase size, without ever going beyond the slots we can represent in object id
+			size_t limit = ObjectIdSlotMask < ConcurrentFreeStack::MaxIndex ? ObjectIdSlotMask : ConcurrentFreeStack::MaxIndex;
+			size_t size = _size.load(std::memory_order_relaxed);
+			size_t reserved;
+			do
+			{
+				if (size >= limit)
+				{
+					throw ExceededPoolLimit();
+				}
+				reserved = count < limit - size ? count : limit - size;
+			} while (!_size.compare_exchange_weak(size, size + reserved, std::memory_order_relaxed));
+
+			// make sure all reserved slots have memory
+			for (size_t page = _slots.page_of(size); page <= _slots.page_of(size + reserved - 1); ++page)
+			{
+				_slots.ensure(_slots.page_begin(page));
+			}
+			first = size;
+			return reserved;
+		}
+
+		template <typename Allocator>
+		bool ConcurrentSlotsTable<Allocator>::retire(ObjectId id, size_t& index)
+		{
+			// get slot and make sure id is used
+			Slot* slot = const_cast<Slot*>(get_slot(id));
+			size_t generation = get_id_generation(id);
+			if (!slot || !(generation & 1))
+			{
+				return false;
+			}
+
+			// take index before releasing, as once released the slot may be reused by other threads
+			index = slot->index.load(std::memory_order_relaxed);
+
+			// move to next (free) generation. if another thread released this id first, we fail here
+			return slot->generation.compare_exchange_strong(generation, (generation + 1) & ObjectIdSlotMask, std::memory_order_acq_rel, std::memory_order_relaxed);
+		}
+
+		template <typename Allocator>
+		bool ConcurrentSlotsTable<Allocator>::release(ObjectId id, size_t& index)
+		{
+			// release and add slot to the free slots
+			if (!retire(id, index))
+			{
+				return false;
+			}
+			_free.push(get_id_slot(id), *this);
+			return true;
+		}
+
+		template <typename Allocator>
+		void ConcurrentSlotsTable<Allocator>::clear()
+		{
+			// release all slots but keep their generations, so ids from before clearing remain invalid
+			_free.clear();
+			for (size_t i = _size.load(std::memory_order_relaxed); i-- > 0;)
+			{
+				Slot& slot = _slots[i];
+				size_t generation = slot.generation.load(std::memory_order_relaxed);
+				if (generation & 1)
+				{
+					slot.generation.store((generation + 1) & ObjectIdSlotMask, std::memory_order_relaxed);
+				}
+				_free.push(i, *this);
+			}
+		}
+	}
+}
+
+#endif
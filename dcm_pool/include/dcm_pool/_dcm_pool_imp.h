@@ -7,6 +7,7 @@
 * \since		2018
 */
 
+#include <algorithm>
 #include "exceptions.h"
 
 
@@ -16,29 +17,194 @@
 
 namespace dcm_pool
 {
-	template <typename T>
-	DcmPool<T>::DcmPool(size_t max_size, size_t reserve, size_t shrink_threshold, DefragModes defrag_mode) :
+	template <typename T, typename Allocator, typename IdTraits>
+	DcmPool<T, Allocator, IdTraits>::DcmPool(size_t max_size, size_t reserve, size_t shrink_threshold, DefragModes defrag_mode, StorageModes storage_mode, const Allocator& allocator) :
+		_objects(storage_mode, max_size, allocator),
+		_ids(IdsAllocator(allocator)),
+		_is_used(FlagsAllocator(allocator)),
+		_slots(IdsAllocator(allocator)),
+		_holes(_ids),
 		_max_size(max_size),
 		_allocated_objects_count(0),
-		_next_object_id(0),
 		_max_used_index_in_vector(0),
 		_shrink_pool_threshold(shrink_threshold),
 		_defrag_mode(defrag_mode),
 		_defrags_count(0),
-		_holes(_objects)
+		_storage_moved_at(0),
+		_pages_changed_at(VersionsAllocator(allocator)),
+		_releases_count(0),
+		_reserved_capacity(0),
+		_released_memory_bytes(0),
+		_first_hole(ObjectPoolMaxIndex),
+		_incremental_defrag_moves(DefaultIncrementalDefragMoves),
+		_holes_to_close(IndicesAllocator(allocator)),
+		_batch_indices(IndicesAllocator(allocator))
 	{
+		// pool can't hold more objects than the slots its ids can represent
+		if (!_max_size || _max_size > IdTraits::SlotMask)
+		{
+			_max_size = IdTraits::SlotMask;
+		}
+
 		// pre-alloc desired size
 		if (reserve)
 		{
-			_objects.reserve(reserve);
+			Reserve(reserve);
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	DcmPool<T, Allocator, IdTraits>::~DcmPool()
+	{
+		Clear();
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	typename DcmPool<T, Allocator, IdTraits>::Ptr DcmPool<T, Allocator, IdTraits>::Alloc()
+	{
+		return Emplace();
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename... Args>
+	typename DcmPool<T, Allocator, IdTraits>::Ptr DcmPool<T, Allocator, IdTraits>::Emplace(Args&&... args)
+	{
+		// get index to allocate on
+		size_t alloc_index = AllocIndex();
+
+		// construct the object directly in pool's memory
+		try
+		{
+			_objects.construct(alloc_index, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			// if we took a hole, return it so it will be filled later
+			if (_allocated_objects_count && alloc_index < _max_used_index_in_vector)
+			{
+				_holes.push_back(alloc_index);
+			}
+			throw;
+		}
+
+		// return the new object pointer
+		return AssignObject(alloc_index);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::AllocN(size_t count, Ptr* out_ptrs)
+	{
+		// nothing to allocate?
+		if (!count)
+		{
+			return;
+		}
+
+		// make sure we have room (and slots) for all objects, before allocating anything
+		if ((_max_size && _allocated_objects_count + count > _max_size) || count > _slots.available())
+		{
+			throw ExceededPoolLimit();
+		}
+
+		// first take holes to fill (unless we keep allocation order)
+		_batch_indices.clear();
+		while (_holes.size() && _batch_indices.size() < count && _defrag_mode != DEFRAG_STABLE)
+		{
+			size_t index = _holes.pop_back();
+
+			// holes beyond max used index are leftovers from releasing the last objects, skip them
+			if (index < _max_used_index_in_vector)
+			{
+				_batch_indices.push_back(index);
+			}
+		}
+		size_t holes_taken = _batch_indices.size();
+
+		// claim the rest as a single range at the end of the pool, and grow storage once if needed
+		// note: if storage had to move objects to grow, cached pointers are no longer valid
+		size_t tail_begin = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		size_t tail_count = count - holes_taken;
+
+		// make sure the new indices fit in the pool's id type (can only fail with narrow ids, when holes are kept)
+		if (tail_begin + tail_count >= IdTraits::InvalidIndex)
+		{
+			for (size_t i = 0; i < holes_taken; ++i)
+			{
+				_holes.push_back(_batch_indices[i]);
+			}
+			throw ExceededPoolLimit();
+		}
+		if (tail_begin + tail_count > _objects.size())
+		{
+			if (_objects.extend(_is_used, tail_begin + tail_count - _objects.size()))
+			{
+				StorageMoved();
+			}
+			_ids.resize(_objects.size(), (Id)IdTraits::InvalidIndex);
+			_is_used.resize(_objects.size());
+		}
+		for (size_t i = 0; i < tail_count; ++i)
+		{
+			_batch_indices.push_back(tail_begin + i);
+		}
+
+		// construct all objects. if one of them throws, destroy the ones we constructed and return the holes we took
+		size_t constructed = 0;
+		try
+		{
+			for (; constructed < count; ++constructed)
+			{
+				_objects.construct(_batch_indices[constructed]);
+			}
+		}
+		catch (...)
+		{
+			for (size_t i = 0; i < constructed; ++i)
+			{
+				_objects.destroy(_batch_indices[i]);
+			}
+			for (size_t i = 0; i < holes_taken; ++i)
+			{
+				_holes.push_back(_batch_indices[i]);
+			}
+			throw;
+		}
+
+		// assign ids and set as used
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t index = _batch_indices[i];
+			ObjectId id = _slots.alloc(index);
+			_ids[index] = (Id)id;
+			_is_used.set(index);
+			if (out_ptrs)
+			{
+				out_ptrs[i] = Ptr(this, id);
+				out_ptrs[i]._set_cached_ptr(&_objects[index], index, _defrags_count, _releases_count);
+			}
+		}
+		_allocated_objects_count += count;
+		if (tail_count)
+		{
+			_max_used_index_in_vector = tail_begin + tail_count - 1;
+		}
+
+		// if defined, call the OnAlloc event handler for all new objects
+		if (OnAlloc)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t index = _batch_indices[i];
+				OnAlloc(_objects[index], _ids[index], *this);
+			}
 		}
 	}
 
-	template <typename T>
-	typename DcmPool<T>::Ptr DcmPool<T>::Alloc()
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::AllocIndex()
 	{
-		// make sure didn't exceed pool limit
-		if (_max_size && _allocated_objects_count >= _max_size)
+		// make sure didn't exceed pool limit, and that we have a slot for the new object's id
+		if ((_max_size && _allocated_objects_count >= _max_size) || !_slots.available())
 		{
 			throw ExceededPoolLimit();
 		}
@@ -46,30 +212,46 @@ namespace dcm_pool
 		// will hole the index to allocate from
 		std::size_t alloc_index;
 
-		// do we have a hole to fill? if so, use it
-		if (_holes.size())
+		// do we have a hole to fill? if so, use it (unless we keep allocation order)
+		while (_holes.size() && _defrag_mode != DEFRAG_STABLE)
 		{
 			// get index to alloc on and remove from holes vector
 			alloc_index = _holes.pop_back();
 
-			// return the new object pointer
-			return AssignObject(alloc_index);
+			// holes beyond max used index are leftovers from releasing the last objects, skip them
+			if (alloc_index >= _max_used_index_in_vector)
+			{
+				continue;
+			}
+
+			return alloc_index;
 		}
 
 		// do we have unused objects at the end of the vector? fill them
-		if (_max_used_index_in_vector + 1 < _objects.size())
+		alloc_index = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		if (alloc_index >= IdTraits::InvalidIndex)
+		{
+			// index doesn't fit in the pool's id type (can only happen with narrow ids, when holes are kept)
+			throw ExceededPoolLimit();
+		}
+		if (alloc_index < _objects.size())
 		{
-			return AssignObject(_max_used_index_in_vector + 1);
+			return alloc_index;
 		}
 
-		// if we got here it means we don't have any hole to fill, and must allocate a new object in pool's vector
-		auto index = _objects.size();
-		_objects.push_back(_internal::ObjectInPool<T>());
-		return AssignObject(index);
+		// if we got here it means we don't have any hole to fill, and must add a new object to pool's storage
+		// note: if storage had to move objects to grow, cached pointers are no longer valid
+		if (_objects.extend(_is_used))
+		{
+			StorageMoved();
+		}
+		_ids.push_back((Id)IdTraits::InvalidIndex);
+		_is_used.push_back(false);
+		return alloc_index;
 	}
 
-	template <typename T>
-	typename DcmPool<T>::Ptr DcmPool<T>::DcmPool<T>::AssignObject(size_t index)
+	template <typename T, typename Allocator, typename IdTraits>
+	typename DcmPool<T, Allocator, IdTraits>::Ptr DcmPool<T, Allocator, IdTraits>::AssignObject(size_t index)
 	{
 		// increase allocated objects count
 		_allocated_objects_count++;
@@ -81,71 +263,128 @@ namespace dcm_pool
 		}
 
 		// get object and id, set it as used
-		_internal::ObjectInPool<T>& obj = _objects[index];
-		ObjectId id = _next_object_id++;
-		obj.set_id(id);
-		obj.set_is_used(true);
+		T& obj = _objects[index];
+		ObjectId id = _slots.alloc(index);
+		_ids[index] = (Id)id;
+		_is_used.set(index);
 
-		// update the pointers table and create a pointer to return
-		_pointers[id] = index;
-		auto ret = DcmPool<T>::Ptr(this, id);
-		ret._set_cached_ptr(&obj.get_object(), _defrags_count);
+		// create a pointer to return
+		auto ret = DcmPool<T, Allocator, IdTraits>::Ptr(this, id);
+		ret._set_cached_ptr(&obj, index, _defrags_count, _releases_count);
 
 		// if defined, call the OnAlloc event handler
-		if (OnAlloc) OnAlloc(obj.get_object(), id, *this);
+		if (OnAlloc) OnAlloc(obj, id, *this);
 
 		// return the object
 		return ret;
 	}
 
-	template <typename T>
-	T& DcmPool<T>::_get_object(ObjectId id)
+	template <typename T, typename Allocator, typename IdTraits>
+	T& DcmPool<T, Allocator, IdTraits>::_get_object(ObjectId id)
 	{
-		size_t index = _pointers.at(id);
-		_internal::ObjectInPool<T>& obj = *(&_objects[index]);
-		return obj.get_object();
+		return _objects[GetIndex(id)];
 	}
 
-	template <typename T>
-	void DcmPool<T>::Release(typename DcmPool<T>::Ptr obj)
+	template <typename T, typename Allocator, typename IdTraits>
+	T& DcmPool<T, Allocator, IdTraits>::_get_object(ObjectId id, size_t& index)
 	{
-		Release(obj._get_id());
+		index = GetIndex(id);
+		return _objects[index];
 	}
 
-	template <typename T>
-	void DcmPool<T>::Release(ObjectId id)
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::GetIndex(ObjectId id) const
 	{
-		// get object index in pool and a reference to the object itself
-		auto index = _pointers[id];
-		_internal::ObjectInPool<T>& obj_ref = _objects[index];
-
-		// sanity test
-		if (!obj_ref.is_used())
+		// make sure id belongs to a used object
+		if (!_slots.is_alive(id))
 		{
 			throw AccessViolation();
 		}
 
+		return _slots.get_index(id);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	bool DcmPool<T, Allocator, IdTraits>::IsAlive(ObjectId id) const
+	{
+		return _slots.is_alive(id);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	T* DcmPool<T, Allocator, IdTraits>::TryGet(ObjectId id)
+	{
+		return _slots.is_alive(id) ? &_objects[_slots.get_index(id)] : NULL;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	const T* DcmPool<T, Allocator, IdTraits>::TryGet(ObjectId id) const
+	{
+		return _slots.is_alive(id) ? &_objects[_slots.get_index(id)] : NULL;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	bool DcmPool<T, Allocator, IdTraits>::TryRelease(ObjectId id)
+	{
+		// not a used object? skip
+		if (!_slots.is_alive(id))
+		{
+			return false;
+		}
+
+		ReleaseAt(_slots.get_index(id), id);
+		return true;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Release(typename DcmPool<T, Allocator, IdTraits>::Ptr obj)
+	{
+		Release(obj._get_id());
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Release(ObjectId id)
+	{
+		// get object index in pool (will throw if not a valid object) and release it
+		ReleaseAt(GetIndex(id), id);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ReleaseAt(size_t index, ObjectId id)
+	{
 		// if defined, call the OnRelease event handler
-		if (OnRelease) OnRelease(obj_ref.get_object(), id, *this);
+		if (OnRelease) OnRelease(_objects[index], id, *this);
 
-		// first, remove object from pointers map
-		_pointers.erase(id);
+		// destroy the object, but keep its memory
+		_objects.destroy(index);
+
+		// free the object slot (and invalidate cached pointers to it)
+		_slots.release(id);
+		IndexReleased(index);
+		_releases_count++;
 
 		// now decrease actual pool size
 		_allocated_objects_count--;
 
 		// set as no longer used
-		obj_ref.set_is_used(false);
+		_is_used.reset(index);
 
 		// if we happened to release the last object in pool, its the easier case - we just decrease the used index as well
+		// note: we skip holes we might have before it, so max used index will always point on a used object
 		if (index == _max_used_index_in_vector)
 		{
-			_max_used_index_in_vector--;
+			_max_used_index_in_vector = _is_used.find_last(_max_used_index_in_vector);
+
+			// if pool is now empty there are no holes to close
+			if (!_allocated_objects_count)
+			{
+				_holes.clear();
+				_first_hole = ObjectPoolMaxIndex;
+			}
 			return;
 		}
 
 		// if got here it means we created a hole. add it to holes vector
-		_holes.push_back(index);
+		AddHole(index);
 
 		// if in immediate defrag mode, do it now
 		if (_defrag_mode == DEFRAG_IMMEDIATE)
@@ -154,37 +393,402 @@ namespace dcm_pool
 		}
 	}
 
-	template <typename T>
-	size_t DcmPool<T>::size() const
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ReleaseN(const ObjectId* ids, size_t count)
+	{
+		// nothing to release?
+		if (!count)
+		{
+			return;
+		}
+
+		// get all objects indices first (will throw if not a valid object), so we either release all objects or none
+		_batch_indices.clear();
+		for (size_t i = 0; i < count; ++i)
+		{
+			_batch_indices.push_back(GetIndex(ids[i]));
+		}
+
+		// make sure no object appears twice, by temporarily clearing the used flags of the objects we release
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t index = _batch_indices[i];
+			if (!_is_used[index])
+			{
+				for (size_t j = 0; j < i; ++j)
+				{
+					_is_used.set(_batch_indices[j]);
+				}
+				throw AccessViolation();
+			}
+			_is_used.reset(index);
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			_is_used.set(_batch_indices[i]);
+		}
+
+		ReleaseBatch(count);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::ApplyPendingReleases()
+	{
+		// take the indices of all queued objects that are still alive. we clear their used flags as we go, to skip
+		// objects that were queued twice
+		_batch_indices.clear();
+		try
+		{
+			_release_queue.Drain([this](ObjectId id)
+			{
+				if (_slots.is_alive(id))
+				{
+					size_t index = _slots.get_index(id);
+					if (_is_used[index])
+					{
+						_is_used.reset(index);
+						_batch_indices.push_back(index);
+					}
+				}
+			});
+		}
+		catch (...)
+		{
+			for (size_t i = 0; i < _batch_indices.size(); ++i)
+			{
+				_is_used.set(_batch_indices[i]);
+			}
+			throw;
+		}
+		size_t count = _batch_indices.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			_is_used.set(_batch_indices[i]);
+		}
+
+		// nothing to release?
+		if (!count)
+		{
+			return 0;
+		}
+
+		// release in index order, so we go over the objects memory forward
+		std::sort(_batch_indices.begin(), _batch_indices.end());
+		ReleaseBatch(count);
+
+		// close holes based on defrag mode (immediate mode already did it)
+		DefragBeforeIterate();
+		return count;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ReleaseBatch(size_t count)
+	{
+		// if defined, call the OnRelease event handler for all objects
+		if (OnRelease)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t index = _batch_indices[i];
+				OnRelease(_objects[index], _ids[index], *this);
+			}
+		}
+
+		// destroy the objects, free their slots and set as no longer used
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t index = _batch_indices[i];
+			_objects.destroy(index);
+			_slots.release(_ids[index]);
+			_is_used.reset(index);
+			IndexReleased(index);
+		}
+		_releases_count++;
+		_allocated_objects_count -= count;
+
+		// if pool is now empty there are no holes to close
+		if (!_allocated_objects_count)
+		{
+			_max_used_index_in_vector = 0;
+			_holes.clear();
+			_first_hole = ObjectPoolMaxIndex;
+			return;
+		}
+
+		// update max used index (skip released objects at the end)
+		_max_used_index_in_vector = _is_used.find_last(_max_used_index_in_vector);
+
+		// all released objects before max used index are now holes
+		bool created_holes = false;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (_batch_indices[i] < _max_used_index_in_vector)
+			{
+				AddHole(_batch_indices[i]);
+				created_holes = true;
+			}
+		}
+
+		// if in immediate defrag mode, close all holes at once
+		if (created_holes && _defrag_mode == DEFRAG_IMMEDIATE)
+		{
+			Defrag();
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::size() const
 	{
 		return _allocated_objects_count;
 	}
 
-	template <typename T>
-	void DcmPool<T>::Clear()
+	template <typename T, typename Allocator, typename IdTraits>
+	T* DcmPool<T, Allocator, IdTraits>::Data()
+	{
+		// only contiguous storage can be accessed as a single memory block
+		if (!_objects.is_contiguous())
+		{
+			throw StorageNotContiguous();
+		}
+
+		// if there are holes in the used range we need to defrag first
+		DefragIfHoles();
+
+		return _objects.data();
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::DefragIfHoles()
+	{
+		if (_allocated_objects_count && _allocated_objects_count != _max_used_index_in_vector + 1)
+		{
+			if (_defrag_mode == DEFRAG_MANUAL)
+			{
+				throw PoolNotDefragged();
+			}
+			Defrag();
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	typename DcmPool<T, Allocator, IdTraits>::iterator DcmPool<T, Allocator, IdTraits>::begin()
+	{
+		// if in deferred defrag mode, do it now
+		DefragBeforeIterate();
+		return iterator(&_objects, &_is_used, 0, UsedSize());
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	_internal::IteratorsRange<typename DcmPool<T, Allocator, IdTraits>::ids_iterator> DcmPool<T, Allocator, IdTraits>::WithIds()
+	{
+		// note: begin() may defrag, so we must take ids data after it
+		iterator first = begin();
+		return _internal::IteratorsRange<ids_iterator>(ids_iterator(first, _ids.data()), ids_iterator());
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	_internal::IteratorsRange<typename DcmPool<T, Allocator, IdTraits>::dense_iterator> DcmPool<T, Allocator, IdTraits>::Dense()
+	{
+		// if there are holes in the used range we need to defrag first
+		DefragIfHoles();
+		return _internal::IteratorsRange<dense_iterator>(dense_iterator(&_objects, 0), dense_iterator(&_objects, (std::ptrdiff_t)_allocated_objects_count));
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	_internal::IteratorsRange<typename DcmPool<T, Allocator, IdTraits>::const_dense_iterator> DcmPool<T, Allocator, IdTraits>::Dense() const
 	{
-		_pointers.clear();
+		// can't defrag a const pool
+		if (_allocated_objects_count && _allocated_objects_count != _max_used_index_in_vector + 1)
+		{
+			throw PoolNotDefragged();
+		}
+		return _internal::IteratorsRange<const_dense_iterator>(const_dense_iterator(&_objects, 0), const_dense_iterator(&_objects, (std::ptrdiff_t)_allocated_objects_count));
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Clear()
+	{
+		// destroy all used objects
+		if (_allocated_objects_count)
+		{
+			_is_used.for_each_used(0, _max_used_index_in_vector + 1, [&](size_t index)
+			{
+				_objects.destroy(index);
+				return true;
+			});
+		}
+
+		_slots.clear();
 		_objects.clear();
+		_ids.clear();
+		_is_used.clear();
 		_holes.clear();
+		_first_hole = ObjectPoolMaxIndex;
 		_allocated_objects_count = 0;
-		_next_object_id = 0;
 		_max_used_index_in_vector = 0;
+
+		// invalidate all cached pointers
+		StorageMoved();
+		_pages_changed_at.clear();
 	}
 
-	template <typename T>
-	void DcmPool<T>::Defrag()
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Defrag()
 	{
-		// no holes to fill? nothing to do here
-		if (!_holes.size())
+		// no holes to fill? only check if we need to shrink memory (objects might have been released from the end)
+		if (!_holes.size() && _first_hole == ObjectPoolMaxIndex)
 		{
+			ShrinkIfNeeded();
 			return;
 		}
 
 		// increase defragging count
 		_defrags_count++;
 
-		// iterate and close holes until we no longer have holes to close
-		while (_holes.size())
+		// close all holes
+		DefragMoves(ObjectPoolMaxIndex);
+
+		// check if we need to shrink memory
+		ShrinkIfNeeded();
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::DefragStep(size_t max_moves)
+	{
+		// no holes to fill or no budget? only check if we need to shrink memory
+		if ((!_holes.size() && _first_hole == ObjectPoolMaxIndex) || !max_moves)
+		{
+			ShrinkIfNeeded();
+			return HolesCount();
+		}
+
+		// increase defragging count
+		_defrags_count++;
+
+		// close some holes
+		DefragMoves(max_moves);
+
+		// check if we need to shrink memory (will only happen if we closed all holes)
+		ShrinkIfNeeded();
+		return HolesCount();
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::DefragFor(std::chrono::microseconds budget)
+	{
+		// how many objects to move between checking the clock
+		const size_t moves_per_check = 64;
+
+		// close holes until we're done or out of time
+		auto deadline = std::chrono::steady_clock::now() + budget;
+		size_t holes_left;
+		do
+		{
+			holes_left = DefragStep(moves_per_check);
+		} while (holes_left && std::chrono::steady_clock::now() < deadline);
+		return holes_left;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::DefragMoves(size_t max_moves)
+	{
+		// keep objects order in stable mode, or move last objects into holes (in bulk if they can be moved with memcpy)
+		if (_defrag_mode == DEFRAG_STABLE)
+		{
+			CompactStable(max_moves);
+		}
+		else
+		{
+			CloseHoles(max_moves, typename _internal::ObjectsStorage<T, Allocator>::Relocatable());
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::AddHole(size_t index)
+	{
+		// in stable mode holes are never filled by new objects, so we only need to know where the first hole is.
+		// note: we can't use the holes list here, as new objects at the end of the pool would override its links.
+		if (_defrag_mode == DEFRAG_STABLE)
+		{
+			if (index < _first_hole)
+			{
+				_first_hole = index;
+			}
+			return;
+		}
+
+		_holes.push_back(index);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::CompactStable(size_t max_moves)
+	{
+		// get the first hole. it might have been filled since, if all objects after it were released and new objects
+		// were allocated at the end of the pool, so make sure its really a hole
+		size_t write = _first_hole;
+		_first_hole = ObjectPoolMaxIndex;
+		while (write < _max_used_index_in_vector && _is_used[write])
+		{
+			write++;
+		}
+
+		// no holes before the last object?
+		if (write >= _max_used_index_in_vector)
+		{
+			return;
+		}
+
+		// shift every run of objects after the first hole back, so objects keep their order (like std::remove_if)
+		size_t read = _is_used.find_next(write + 1, _max_used_index_in_vector + 1);
+		size_t moved = 0;
+		while (read <= _max_used_index_in_vector)
+		{
+			// out of budget? everything before 'write' is compacted, so next time we continue from there
+			if (moved == max_moves)
+			{
+				_first_hole = write;
+				return;
+			}
+
+			// find objects run (up to our budget) and move it with a single call
+			size_t run_begin = read;
+			while (read <= _max_used_index_in_vector && _is_used[read] && read - run_begin < max_moves - moved)
+			{
+				read++;
+			}
+			size_t count = read - run_begin;
+			moved += count;
+			_objects.move_objects(run_begin, write, count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				_ids[write + i] = _ids[run_begin + i];
+				_is_used.set(write + i);
+				_slots.set_index(_ids[write + i], write + i);
+				IndexMoved(run_begin + i);
+				IndexMoved(write + i);
+			}
+			write += count;
+
+			// clear used flags of the part of the run we didn't override
+			for (size_t i = (write > run_begin ? write : run_begin); i < read; ++i)
+			{
+				_is_used.reset(i);
+			}
+
+			// skip holes to the next objects run
+			read = _is_used.find_next(read, _max_used_index_in_vector + 1);
+		}
+
+		// update max used index
+		_max_used_index_in_vector = write - 1;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::CloseHoles(size_t max_moves, std::false_type)
+	{
+		// iterate and close holes until we no longer have holes to close (or out of budget)
+		size_t moved = 0;
+		while (_holes.size() && moved < max_moves)
 		{
 			// get current index to move
 			auto index_to_fill = _holes.pop_back();
@@ -195,114 +799,429 @@ namespace dcm_pool
 				continue;
 			}
 
-			// move last object into this position
-			_objects[index_to_fill] = std::move(_objects[_max_used_index_in_vector]);
+			// move last object into this position (the hole is not constructed, so we construct it from the last object)
+			_objects.move_objects(_max_used_index_in_vector, index_to_fill, 1);
+			_ids[index_to_fill] = _ids[_max_used_index_in_vector];
+			_is_used.set(index_to_fill);
+			_is_used.reset(_max_used_index_in_vector);
+			IndexMoved(index_to_fill);
+			IndexMoved(_max_used_index_in_vector);
 			
 			// update max used index in vector
-			do 
+			_max_used_index_in_vector = _is_used.find_last(_max_used_index_in_vector);
+
+			// update the slots table
+			_slots.set_index(_ids[index_to_fill], index_to_fill);
+			moved++;
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::CloseHoles(size_t max_moves, std::true_type)
+	{
+		// holes list is stored in the ids of the holes we're about to fill, so drain it first
+		_holes_to_close.clear();
+		while (_holes.size())
+		{
+			_holes_to_close.push_back(_holes.pop_back());
+		}
+
+		// note: every unused index before the last used object is a hole, so we can find holes runs using the used flags
+		size_t right = _max_used_index_in_vector;
+		size_t moved = 0;
+		for (size_t hole = 0; hole < _holes_to_close.size() && moved < max_moves; ++hole)
+		{
+			// get next hole to fill. skip it if it was already filled as part of a previous run, or is beyond the last object
+			size_t left = _holes_to_close[hole];
+			if (left >= right || _is_used[left])
 			{
-				_max_used_index_in_vector--;
+				continue;
 			}
-			while (_max_used_index_in_vector > 0 && !_objects[_max_used_index_in_vector].is_used());
 
-			// update the pointers table
-			_pointers[_objects[index_to_fill].get_id()] = index_to_fill;
+			// fill the holes run that starts here
+			while (left < right && !_is_used[left] && moved < max_moves)
+			{
+				// count holes run (up to our budget), and objects run that ends at the last used object (not longer than holes run)
+				size_t holes_run = _is_used.find_next(left + 1, right) - left;
+				if (holes_run > max_moves - moved)
+				{
+					holes_run = max_moves - moved;
+				}
+				size_t count = 1;
+				while (count < holes_run && _is_used[right - count])
+				{
+					count++;
+				}
+
+				// move the objects run into the head of the holes run, with a single copy
+				size_t from = right + 1 - count;
+				_objects.move_objects(from, left, count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					_ids[left + i] = _ids[from + i];
+					_is_used.set(left + i);
+					_is_used.reset(from + i);
+					_slots.set_index(_ids[left + i], left + i);
+					IndexMoved(from + i);
+					IndexMoved(left + i);
+				}
+				left += count;
+				moved += count;
+
+				// find the new last used object
+				right = _is_used.find_last(from - 1);
+			}
 		}
 
-		// check if we need to resize vector
-		if (_objects.size() - _max_used_index_in_vector > _shrink_pool_threshold)
+		// update max used index
+		_max_used_index_in_vector = right;
+
+		// out of budget? return the holes we didn't close to the holes list
+		if (moved == max_moves)
 		{
-			ClearUnusedMemory();
+			for (size_t hole = 0; hole < _holes_to_close.size(); ++hole)
+			{
+				size_t index = _holes_to_close[hole];
+				if (index < right && !_is_used[index])
+				{
+					_holes.push_back(index);
+				}
+			}
 		}
 	}
 
-	template <typename T>
-	void DcmPool<T>::Reserve(size_t amount)
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Reserve(size_t amount)
 	{
-		_objects.reserve(amount);
+		// reserving might move objects, so cached pointers are no longer valid
+		if (_objects.reserve(amount, _is_used))
+		{
+			StorageMoved();
+		}
+
+		_ids.reserve(amount);
+		_is_used.reserve(amount);
+
+		// never shrink below reserved capacity
+		if (amount > _reserved_capacity)
+		{
+			_reserved_capacity = amount;
+		}
 	}
 
-	template <typename T>
-	void DcmPool<T>::IterateEx(PoolIteratorEx<T> callback)
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::DefragBeforeIterate()
 	{
-		// if in deferred defrag mode, do it now
-		if (_defrag_mode == DEFRAG_DEFERRED)
+		// deferred modes close all holes before iterating, incremental mode closes just some of them
+		if (_defrag_mode == DEFRAG_DEFERRED || _defrag_mode == DEFRAG_STABLE)
 		{
 			Defrag();
 		}
+		else if (_defrag_mode == DEFRAG_INCREMENTAL)
+		{
+			DefragStep(_incremental_defrag_moves);
+		}
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename Callback>
+	void DcmPool<T, Allocator, IdTraits>::ForEach(Callback&& callback)
+	{
+		// if in deferred defrag mode, do it now
+		DefragBeforeIterate();
 
-		// iterate objects
-		for (size_t i = 0; i <= _max_used_index_in_vector; ++i)
+		// nothing to iterate?
+		if (!_allocated_objects_count)
 		{
-			_internal::ObjectInPool<T>& obj = _objects[i];
-			if (obj.is_used())
+			return;
+		}
+
+		// iterate all objects
+		bool has_holes = _allocated_objects_count != _max_used_index_in_vector + 1;
+		ForEachInRange(callback, 0, _max_used_index_in_vector + 1, has_holes);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename Callback>
+	bool DcmPool<T, Allocator, IdTraits>::ForEachInRange(Callback& callback, size_t begin, size_t end, bool has_holes)
+	{
+		// iterate objects, one contiguous page at a time. if there are no holes we don't need to check which objects are used,
+		// so the callback is inlined into a plain loop over the objects
+		bool completed = true;
+		_objects.for_each_page(begin, end, [&](T* objects, size_t first, size_t count)
+		{
+			if (!has_holes)
 			{
-				if (callback(obj.get_object(), obj.get_id(), *this) == IterationReturnCode::ITER_BREAK)
-					break;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (!_internal::invoke_iteration_callback(callback, objects[i], _ids[first + i], *this, _internal::CallbackRank<2>()))
+						return completed = false;
+				}
+				return true;
 			}
-		}
+			return completed = _is_used.for_each_used(first, first + count, [&](size_t index)
+			{
+				return _internal::invoke_iteration_callback(callback, objects[index - first], _ids[index], *this, _internal::CallbackRank<2>());
+			});
+		});
+		return completed;
 	}
 
-	template <typename T>
-	void DcmPool<T>::Iterate(PoolIterator<T> callback)
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename Callback>
+	void DcmPool<T, Allocator, IdTraits>::ParallelIterate(Callback&& callback, size_t grain, ThreadPool& workers)
 	{
-		// if in deferred defrag mode, do it now
-		if (_defrag_mode == DEFRAG_DEFERRED)
+		// defrag once (based on defrag mode) and split the pool into chunks
+		size_t chunks_count = _prepare_chunks(grain, workers.size());
+
+		// run chunks on the thread pool
+		std::atomic<bool> stop(false);
+		workers.ParallelFor(chunks_count, [&](size_t chunk)
 		{
-			Defrag();
+			if (stop.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+			if (!_iterate_chunk(callback, chunk, grain))
+			{
+				stop.store(true, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	size_t DcmPool<T, Allocator, IdTraits>::_prepare_chunks(size_t& grain, size_t threads_count)
+	{
+		// if in deferred defrag mode, do it now (once, before splitting the work)
+		DefragBeforeIterate();
+
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return 0;
 		}
 
-		// iterate objects
-		for (size_t i = 0; i <= _max_used_index_in_vector; ++i)
+		// pick chunk size, and round it up to whole used-flags words (64 objects, which is also a multiple of cache line size)
+		size_t used_size = _max_used_index_in_vector + 1;
+		if (!grain)
 		{
-			_internal::ObjectInPool<T>& obj = _objects[i];
-			if (obj.is_used())
+			grain = used_size / (threads_count * 4);
+			if (grain < MinParallelIterateGrain)
 			{
-				callback(obj.get_object(), obj.get_id());
+				grain = MinParallelIterateGrain;
 			}
 		}
+		grain = (grain + _internal::BitmapWordBits - 1) / _internal::BitmapWordBits * _internal::BitmapWordBits;
+		return (used_size + grain - 1) / grain;
 	}
-    
-    template <typename T>
-	void DcmPool<T>::IterateEx(ConstPoolIteratorEx<T> callback) const
+
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename Callback>
+	bool DcmPool<T, Allocator, IdTraits>::_iterate_chunk(Callback& callback, size_t chunk, size_t grain)
+	{
+		size_t used_size = _max_used_index_in_vector + 1;
+		size_t begin = chunk * grain;
+		size_t end = (used_size - begin < grain) ? used_size : begin + grain;
+		return ForEachInRange(callback, begin, end, _allocated_objects_count != used_size);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	template <typename Callback>
+	void DcmPool<T, Allocator, IdTraits>::ForEach(Callback&& callback) const
 	{
-		// iterate objects
-		for (size_t i = 0; i <= _max_used_index_in_vector; ++i)
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return;
+		}
+
+		// iterate objects, one contiguous page at a time (see non-const version)
+		bool has_holes = _allocated_objects_count != _max_used_index_in_vector + 1;
+		_objects.for_each_page(0, _max_used_index_in_vector + 1, [&](const T* objects, size_t first, size_t count)
 		{
-			_internal::ObjectInPool<T>& obj = _objects[i];
-			if (obj.is_used())
+			if (!has_holes)
 			{
-				if (callback(obj.get_object(), obj.get_id(), *this) == IterationReturnCode::ITER_BREAK)
-					break;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (!_internal::invoke_iteration_callback(callback, objects[i], _ids[first + i], *this, _internal::CallbackRank<2>()))
+						return false;
+				}
+				return true;
 			}
+			return _is_used.for_each_used(first, first + count, [&](size_t index)
+			{
+				return _internal::invoke_iteration_callback(callback, objects[index - first], _ids[index], *this, _internal::CallbackRank<2>());
+			});
+		});
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::IterateEx(PoolIteratorEx<T, Allocator, IdTraits> callback)
+	{
+		// if in deferred defrag mode, do it now
+		DefragBeforeIterate();
+
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return;
 		}
+
+		// iterate objects, one contiguous page at a time
+		_objects.for_each_page(0, _max_used_index_in_vector + 1, [&](T* objects, size_t first, size_t count)
+		{
+			// skip holes using the used objects bitmap
+			return _is_used.for_each_used(first, first + count, [&](size_t index)
+			{
+				return callback(objects[index - first], _ids[index], *this) != IterationReturnCode::ITER_BREAK;
+			});
+		});
 	}
 
-	template <typename T>
-	void DcmPool<T>::Iterate(ConstPoolIterator<T> callback) const
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Iterate(PoolIterator<T> callback)
 	{
-		// iterate objects
-		for (size_t i = 0; i <= _max_used_index_in_vector; ++i)
+		// if in deferred defrag mode, do it now
+		DefragBeforeIterate();
+
+		// nothing to iterate?
+		if (!_allocated_objects_count)
 		{
-			_internal::ObjectInPool<T>& obj = _objects[i];
-			if (obj.is_used())
+			return;
+		}
+
+		// iterate objects, one contiguous page at a time
+		_objects.for_each_page(0, _max_used_index_in_vector + 1, [&](T* objects, size_t first, size_t count)
+		{
+			// skip holes using the used objects bitmap
+			return _is_used.for_each_used(first, first + count, [&](size_t index)
 			{
-				callback(obj.get_object(), obj.get_id());
-			}
+				callback(objects[index - first], _ids[index]);
+				return true;
+			});
+		});
+	}
+    
+    template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::IterateEx(ConstPoolIteratorEx<T, Allocator, IdTraits> callback) const
+	{
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return;
+		}
+
+		// iterate objects, one contiguous page at a time
+		_objects.for_each_page(0, _max_used_index_in_vector + 1, [&](const T* objects, size_t first, size_t count)
+		{
+			// skip holes using the used objects bitmap
+			return _is_used.for_each_used(first, first + count, [&](size_t index)
+			{
+				return callback(objects[index - first], _ids[index], *this) != IterationReturnCode::ITER_BREAK;
+			});
+		});
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::Iterate(ConstPoolIterator<T> callback) const
+	{
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return;
 		}
+
+		// iterate objects, one contiguous page at a time
+		_objects.for_each_page(0, _max_used_index_in_vector + 1, [&](const T* objects, size_t first, size_t count)
+		{
+			// skip holes using the used objects bitmap
+			return _is_used.for_each_used(first, first + count, [&](size_t index)
+			{
+				callback(objects[index - first], _ids[index]);
+				return true;
+			});
+		});
 	}
 
-	template <typename T>
-	void DcmPool<T>::ClearUnusedMemory()
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ClearUnusedMemory()
 	{
-		// make sure there are not holes
-		if (_holes.size())
+		// make sure there are no holes (holes beyond max used index are just leftovers from releasing the last objects)
+		size_t used_size = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		if (_allocated_objects_count != used_size)
 		{
 			throw CannotResizeWhileNotDefragged();
 		}
+		_holes.clear();
+		_first_hole = ObjectPoolMaxIndex;
+
+		// release all unused memory
+		ShrinkMemory(0);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ShrinkIfNeeded()
+	{
+		// not enough unused capacity to bother?
+		size_t used_size = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		size_t min_capacity = used_size > _reserved_capacity ? used_size : _reserved_capacity;
+		if (_objects.capacity() <= min_capacity || _objects.capacity() - min_capacity <= _shrink_pool_threshold)
+		{
+			return;
+		}
+
+		// can't shrink while there are holes in the used range
+		if (_allocated_objects_count != used_size)
+		{
+			return;
+		}
+		_holes.clear();
+		_first_hole = ObjectPoolMaxIndex;
+
+		// shrink, but keep some free capacity so we won't reallocate again as soon as pool grows back
+		ShrinkMemory(_shrink_pool_threshold / 2);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::StorageMoved()
+	{
+		_defrags_count++;
+		_storage_moved_at = _defrags_count;
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	void DcmPool<T, Allocator, IdTraits>::ShrinkMemory(size_t free_capacity)
+	{
+		// cut the unused end of the pool (objects past the max used index are already destroyed, so only sizes change)
+		size_t new_size = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		_objects.truncate(new_size);
+		_ids.resize(new_size);
+		_is_used.resize(new_size);
+
+		// return objects memory to the system. this might move objects, so cached pointers are no longer valid
+		size_t keep_capacity = new_size + free_capacity;
+		if (keep_capacity < _reserved_capacity)
+		{
+			keep_capacity = _reserved_capacity;
+		}
+		bool moved;
+		_released_memory_bytes += _objects.release_unused_memory(keep_capacity, moved, _is_used);
+		if (moved)
+		{
+			StorageMoved();
+		}
 
-		// resize objects pool
-		_objects.resize(_max_used_index_in_vector + 1);
+		// shrink ids as well
+		if (_ids.capacity() > keep_capacity)
+		{
+			size_t prev_capacity = _ids.capacity();
+			vector<Id, IdsAllocator> shrunk_ids(_ids.get_allocator());
+			shrunk_ids.reserve(keep_capacity);
+			shrunk_ids.assign(_ids.begin(), _ids.end());
+			shrunk_ids.swap(_ids);
+			_released_memory_bytes += (prev_capacity - _ids.capacity()) * sizeof(Id);
+			_is_used.shrink_to_fit();
+		}
 	}
 }
 
@@ -9,18 +9,19 @@
 
 #ifndef __HOLES_LIST_IMP__
 #define __HOLES_LIST_IMP__
+#include <stdexcept>
 
 namespace dcm_pool
 {
 	namespace _internal
 	{
-		template <typename T>
-		void HolesList<T>::push_back(size_t hole_index)
+		template <typename TLinks>
+		void HolesList<TLinks>::push_back(size_t hole_index)
 		{
 			// if not empty, take the current first index and set it as the id of the new hole
 			if (_size)
 			{
-				_objects[hole_index].set_id(_first_index);
+				set_hole_link(_links, hole_index, _first_index);
 			}
 
 			// set new first index and increase size
@@ -28,13 +29,13 @@ namespace dcm_pool
 			_size++;
 		}
 
-		template <typename T>
-		size_t HolesList<T>::pop_back()
+		template <typename TLinks>
+		size_t HolesList<TLinks>::pop_back()
 		{
 			// if size is 0, exception
 			if (!_size)
 			{
-				throw new std::out_of_range("Objects pool holes list out of range!");
+				throw std::out_of_range("Objects pool holes list out of range!");
 			}
 
 			// special case - if its last item just return _first_index and zero size
@@ -48,15 +49,15 @@ namespace dcm_pool
 			size_t to_ret = _first_index;
 
 			// set the new first index
-			_first_index = _objects[to_ret].get_id();
+			_first_index = get_hole_link(_links, to_ret);
 
 			// decrease size and return index
 			_size--;
 			return to_ret;
 		}
 
-		template <typename T>
-		void HolesList<T>::clear()
+		template <typename TLinks>
+		void HolesList<TLinks>::clear()
 		{
 			_size = 0;
 		}
@@ -15,38 +15,55 @@
 
 namespace dcm_pool
 {
-	template <typename T>
-	ObjectPtr<T>::ObjectPtr(DcmPool<T>* pool, ObjectId id) : 
+	template <typename T, typename Allocator, typename IdTraits>
+	ObjectPtr<T, Allocator, IdTraits>::ObjectPtr(DcmPool<T, Allocator, IdTraits>* pool, ObjectId id) : 
 		_pool(pool), 
 		_id(id),
-		_pool_defrag_version(-1)
+		_cached_ptr(NULL),
+		_pool_releases_count(0),
+		_pool_defrag_version(-1),
+		_cached_index(0)
 	{
 	}
 
-	template <typename T>
-	ObjectId ObjectPtr<T>::_get_id() const
+	template <typename T, typename Allocator, typename IdTraits>
+	ObjectId ObjectPtr<T, Allocator, IdTraits>::_get_id() const
 	{
 		return _id;
 	}
 
-	template <typename T>
-	T& ObjectPtr<T>::operator*(void)
+	template <typename T, typename Allocator, typename IdTraits>
+	bool ObjectPtr<T, Allocator, IdTraits>::IsAlive() const
 	{
-		// check if we have a valid cached pointer to return
-		if (_pool_defrag_version == _pool->_get_defrags_count())
+		return _pool && _pool->IsAlive(_id);
+	}
+
+	template <typename T, typename Allocator, typename IdTraits>
+	T& ObjectPtr<T, Allocator, IdTraits>::operator*(void)
+	{
+		// check if we have a valid cached pointer to return (nothing was moved or released since we cached it)
+		if (_pool_defrag_version == _pool->_get_defrags_count() && _pool_releases_count == _pool->_get_releases_count())
+			return *_cached_ptr;
+
+		// pool was defragged or objects were released, but if nothing changed in our object's page the cached pointer is still valid
+		if (_cached_ptr && !_pool->_moved_since(_cached_index, _pool_defrag_version))
+		{
+			_pool_defrag_version = _pool->_get_defrags_count();
+			_pool_releases_count = _pool->_get_releases_count();
 			return *_cached_ptr;
+		}
 
-		// if not get the pointer and cache it
-		T* ret = &(_pool->_get_object(_id));
-		_cached_ptr = ret;
-		_pool_defrag_version = _pool->_get_defrags_count();
+		// if not get the pointer and cache it (throws if object was released)
+		size_t index;
+		T* ret = &(_pool->_get_object(_id, index));
+		_set_cached_ptr(ret, index, _pool->_get_defrags_count(), _pool->_get_releases_count());
 
 		// return pointer
 		return *ret;
 	}
 
-	template <typename T>
-	T* ObjectPtr<T>::operator->(void)
+	template <typename T, typename Allocator, typename IdTraits>
+	T* ObjectPtr<T, Allocator, IdTraits>::operator->(void)
 	{
 		return &(this->operator*());
 	}
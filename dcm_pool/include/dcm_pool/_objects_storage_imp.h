@@ -0,0 +1,432 @@
+/*!
+* \file	include\dcm_pool\_objects_storage_imp.h.
+*
+* \brief		Implement the ObjectsStorage template class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#ifndef __OBJECTS_STORAGE_IMP__
+#define __OBJECTS_STORAGE_IMP__
+
+#include <utility>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "exceptions.h"
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		template <typename T, typename Allocator>
+		ObjectsStorage<T, Allocator>::ObjectsStorage(StorageModes mode, size_t max_objects, const Allocator& allocator) :
+			_allocator(allocator),
+			_mode(mode),
+			_pages(PagesAllocator(allocator)),
+			_size(0),
+			_capacity(0),
+			_reserved_bytes(0),
+			_committed_bytes(0),
+			_commit_granularity(0),
+			_explicit_huge_pages(false)
+		{
+			// in virtual mode, reserve address space for max objects up front (without committing it)
+			if (is_virtual())
+			{
+				// can't reserve without knowing the max size
+				if (!max_objects)
+				{
+					_mode = STORAGE_CONTIGUOUS;
+				}
+				// with huge pages we commit whole huge pages, so they won't be split into regular pages
+				else if (_mode == STORAGE_VIRTUAL_HUGE_PAGES)
+				{
+					_commit_granularity = HugePageSize;
+					_reserved_bytes = ((max_objects * sizeof(T) + _commit_granularity - 1) / _commit_granularity) * _commit_granularity;
+					_pages.push_back((T*)reserve_huge_pages_memory(_reserved_bytes, _explicit_huge_pages));
+				}
+				else
+				{
+					_commit_granularity = get_virtual_page_size();
+					_reserved_bytes = ((max_objects * sizeof(T) + _commit_granularity - 1) / _commit_granularity) * _commit_granularity;
+					_pages.push_back((T*)reserve_virtual_memory(_reserved_bytes));
+				}
+			}
+
+			// in paged mode, calculate shift and mask from page size
+			if (_mode == STORAGE_PAGED)
+			{
+				_page_shift = 0;
+				while ((size_t(1) << _page_shift) < StoragePageSize)
+				{
+					_page_shift++;
+				}
+				_page_mask = StoragePageSize - 1;
+			}
+			// in contiguous mode the whole storage is a single page
+			else
+			{
+				_page_shift = sizeof(size_t) * 8 - 1;
+				_page_mask = ObjectPoolMaxIndex;
+			}
+		}
+
+		template <typename T, typename Allocator>
+		ObjectsStorage<T, Allocator>::~ObjectsStorage()
+		{
+			// note: objects are destroyed by the storage owner, we only free memory here
+
+			// in virtual mode release the whole reserved range
+			if (is_virtual())
+			{
+				release_virtual_memory(_pages[0], _reserved_bytes);
+				return;
+			}
+
+			// free pages memory
+			size_t page_capacity = _mode == STORAGE_PAGED ? StoragePageSize : _capacity;
+			for (size_t i = 0; i < _pages.size(); ++i)
+			{
+				if (_pages[i])
+				{
+					deallocate_block(_pages[i], page_capacity);
+				}
+			}
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::extend(const Flags& is_used, size_t count)
+		{
+			// grow if needed
+			bool moved = false;
+			if (_size + count > _capacity)
+			{
+				moved = grow(_size + count, is_used);
+			}
+
+			// add the new (unconstructed) objects
+			_size += count;
+			return moved;
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::reserve(size_t amount, const Flags& is_used)
+		{
+			return amount > _capacity ? grow(amount, is_used) : false;
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		size_t ObjectsStorage<T, Allocator>::release_unused_memory(size_t keep_capacity, bool& moved, const Flags& is_used)
+		{
+			moved = false;
+
+			// never release memory of existing objects
+			if (keep_capacity < _size)
+			{
+				keep_capacity = _size;
+			}
+
+			// nothing to release?
+			if (keep_capacity >= _capacity)
+			{
+				return 0;
+			}
+
+			// paged mode: free the tail pages we no longer need
+			if (_mode == STORAGE_PAGED)
+			{
+				size_t pages_to_keep = (keep_capacity + StoragePageSize - 1) / StoragePageSize;
+				size_t released_pages = _pages.size() - pages_to_keep;
+				while (_pages.size() > pages_to_keep)
+				{
+					deallocate_block(_pages.back(), StoragePageSize);
+					_pages.pop_back();
+				}
+				_capacity = _pages.size() * StoragePageSize;
+				return released_pages * StoragePageSize * sizeof(T);
+			}
+
+			// virtual mode: decommit the tail of the committed range, but keep it reserved
+			if (is_virtual())
+			{
+				size_t keep_bytes = ((keep_capacity * sizeof(T) + _commit_granularity - 1) / _commit_granularity) * _commit_granularity;
+				if (keep_bytes >= _committed_bytes)
+				{
+					return 0;
+				}
+				size_t released = _committed_bytes - keep_bytes;
+				decommit_virtual_memory((char*)_pages[0] + keep_bytes, released);
+				_committed_bytes = keep_bytes;
+				_capacity = _committed_bytes / sizeof(T);
+				return released;
+			}
+
+			// contiguous mode: move objects into a smaller block
+			size_t released = (_capacity - keep_capacity) * sizeof(T);
+			moved = relocate(keep_capacity, is_used);
+			return released;
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::grow(size_t min_capacity, const Flags& is_used)
+		{
+			// paged mode: add pages until we have enough capacity. existing objects never move.
+			if (_mode == STORAGE_PAGED)
+			{
+				while (_capacity < min_capacity)
+				{
+					_pages.push_back(allocate_block(StoragePageSize));
+					_capacity += StoragePageSize;
+				}
+				return false;
+			}
+
+			// virtual mode: commit more of the reserved range. existing objects never move.
+			if (is_virtual())
+			{
+				commit(min_capacity);
+				return false;
+			}
+
+			// contiguous mode: move all objects into a new block (at least double the size)
+			size_t new_capacity = _capacity * 2;
+			if (new_capacity < min_capacity)
+			{
+				new_capacity = min_capacity;
+			}
+			return relocate(new_capacity, is_used);
+		}
+
+		template <typename T, typename Allocator>
+		void ObjectsStorage<T, Allocator>::move_objects(size_t from, size_t to, size_t count)
+		{
+			// move page by page, as in paged mode ranges might cross pages boundaries.
+			// we go forward, so if ranges overlap (to < from) we never override objects we didn't move yet.
+			while (count)
+			{
+				// note: we count objects after the first one, since in contiguous mode mask + 1 would overflow
+				size_t left_in_from_page = _page_mask - (from & _page_mask);
+				size_t left_in_to_page = _page_mask - (to & _page_mask);
+				size_t chunk = count - 1;
+				if (chunk > left_in_from_page) chunk = left_in_from_page;
+				if (chunk > left_in_to_page) chunk = left_in_to_page;
+				chunk++;
+				move_range(&(*this)[to], &(*this)[from], chunk, Relocatable());
+				from += chunk;
+				to += chunk;
+				count -= chunk;
+			}
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::relocate(size_t new_capacity, const Flags& is_used)
+		{
+			return relocate(new_capacity, is_used, Relocatable(), UseRealloc());
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::relocate(size_t new_capacity, const Flags&, std::true_type, std::true_type)
+		{
+			// free the block if we don't keep anything
+			T* old_block = _pages.empty() ? NULL : _pages[0];
+			if (!new_capacity)
+			{
+				free(old_block);
+				if (old_block)
+				{
+					_pages[0] = NULL;
+				}
+				_capacity = 0;
+				return false;
+			}
+
+			// realloc can often grow or shrink the block in place, and if not it copies the whole block for us
+			T* new_block = (T*)realloc((void*)old_block, new_capacity * sizeof(T));
+			if (!new_block)
+			{
+				throw std::bad_alloc();
+			}
+			if (_pages.empty())
+			{
+				_pages.push_back(new_block);
+			}
+			_pages[0] = new_block;
+			_capacity = new_capacity;
+			return new_block != old_block && _size != 0;
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::relocate(size_t new_capacity, const Flags&, std::true_type, std::false_type)
+		{
+			// allocate the new block (if we keep anything)
+			T* new_block = new_capacity ? allocate_block(new_capacity) : NULL;
+
+			// no previous block? we're done
+			if (_pages.empty())
+			{
+				_pages.push_back(new_block);
+				_capacity = new_capacity;
+				return false;
+			}
+
+			// copy the whole used range with a single memcpy (holes are copied too, but that's cheaper than checking them)
+			T* old_block = _pages[0];
+			if (_size && new_block)
+			{
+				memcpy((void*)new_block, (const void*)old_block, _size * sizeof(T));
+			}
+			if (old_block)
+			{
+				deallocate_block(old_block, _capacity);
+			}
+			_pages[0] = new_block;
+			_capacity = new_capacity;
+			return _size != 0;
+		}
+
+		template <typename T, typename Allocator>
+		template <typename Flags>
+		bool ObjectsStorage<T, Allocator>::relocate(size_t new_capacity, const Flags& is_used, std::false_type, std::false_type)
+		{
+			// allocate the new block (if we keep anything)
+			T* new_block = new_capacity ? allocate_block(new_capacity) : NULL;
+
+			// no previous block? we're done
+			if (_pages.empty())
+			{
+				_pages.push_back(new_block);
+				_capacity = new_capacity;
+				return false;
+			}
+
+			// move (or copy, if move may throw) used objects to new block. if one of them throws, destroy the ones we
+			// built and free the new block, so the old block stays as it was (same guarantee as std::vector)
+			T* old_block = _pages[0];
+			bool moved = false;
+			size_t built = 0;
+			try
+			{
+				for (; built < _size; ++built)
+				{
+					if (is_used[built])
+					{
+						ObjectsAllocatorTraits::construct(_allocator, &new_block[built], std::move_if_noexcept(old_block[built]));
+						moved = true;
+					}
+				}
+			}
+			catch (...)
+			{
+				for (size_t i = 0; i < built; ++i)
+				{
+					if (is_used[i])
+					{
+						ObjectsAllocatorTraits::destroy(_allocator, &new_block[i]);
+					}
+				}
+				if (new_block)
+				{
+					deallocate_block(new_block, new_capacity);
+				}
+				throw;
+			}
+
+			// only now destroy the old objects and free the old block
+			for (size_t i = 0; i < _size; ++i)
+			{
+				if (is_used[i])
+				{
+					ObjectsAllocatorTraits::destroy(_allocator, &old_block[i]);
+				}
+			}
+			if (old_block)
+			{
+				deallocate_block(old_block, _capacity);
+			}
+			_pages[0] = new_block;
+			_capacity = new_capacity;
+			return moved;
+		}
+
+		template <typename T, typename Allocator>
+		void ObjectsStorage<T, Allocator>::move_range(T* dest, T* src, size_t count, std::true_type)
+		{
+			memmove((void*)dest, (const void*)src, count * sizeof(T));
+		}
+
+		template <typename T, typename Allocator>
+		void ObjectsStorage<T, Allocator>::move_range(T* dest, T* src, size_t count, std::false_type)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				ObjectsAllocatorTraits::construct(_allocator, &dest[i], std::move(src[i]));
+				ObjectsAllocatorTraits::destroy(_allocator, &src[i]);
+			}
+		}
+
+		template <typename T, typename Allocator>
+		T* ObjectsStorage<T, Allocator>::allocate_block(size_t count)
+		{
+			if (UseRealloc::value)
+			{
+				T* ret = (T*)malloc(count * sizeof(T));
+				if (!ret)
+				{
+					throw std::bad_alloc();
+				}
+				return ret;
+			}
+			return ObjectsAllocatorTraits::allocate(_allocator, count);
+		}
+
+		template <typename T, typename Allocator>
+		void ObjectsStorage<T, Allocator>::deallocate_block(T* block, size_t count)
+		{
+			if (UseRealloc::value)
+			{
+				free(block);
+				return;
+			}
+			ObjectsAllocatorTraits::deallocate(_allocator, block, count);
+		}
+
+		template <typename T, typename Allocator>
+		void ObjectsStorage<T, Allocator>::commit(size_t min_capacity)
+		{
+			// make sure we don't exceed reserved range
+			size_t needed_bytes = min_capacity * sizeof(T);
+			if (needed_bytes > _reserved_bytes)
+			{
+				throw ExceededPoolLimit();
+			}
+
+			// commit at least double the currently committed memory, to reduce system calls
+			size_t new_committed = _committed_bytes * 2;
+			if (new_committed < needed_bytes)
+			{
+				new_committed = needed_bytes;
+			}
+			new_committed = ((new_committed + _commit_granularity - 1) / _commit_granularity) * _commit_granularity;
+			if (new_committed > _reserved_bytes)
+			{
+				new_committed = _reserved_bytes;
+			}
+
+			// commit the new part of the range
+			commit_virtual_memory((char*)_pages[0] + _committed_bytes, new_committed - _committed_bytes);
+			_committed_bytes = new_committed;
+			_capacity = _committed_bytes / sizeof(T);
+		}
+	}
+}
+
+#endif
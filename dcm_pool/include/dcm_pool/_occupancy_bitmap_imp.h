@@ -0,0 +1,150 @@
+/*!
+* \file	include\dcm_pool\_occupancy_bitmap_imp.h.
+*
+* \brief		Implement the OccupancyBitmap class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#ifndef __OCCUPANCY_BITMAP_IMP__
+#define __OCCUPANCY_BITMAP_IMP__
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		inline size_t lowest_set_bit(BitmapWord word)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return (size_t)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return index;
+#else
+			size_t index = 0;
+			while (!(word & 1)) { word >>= 1; index++; }
+			return index;
+#endif
+		}
+
+		inline size_t highest_set_bit(BitmapWord word)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return BitmapWordBits - 1 - (size_t)__builtin_clzll(word);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long index;
+			_BitScanReverse64(&index, word);
+			return index;
+#else
+			size_t index = 0;
+			while (word >>= 1) { index++; }
+			return index;
+#endif
+		}
+
+		template <typename Allocator>
+		void OccupancyBitmap<Allocator>::resize(size_t size)
+		{
+			_words.resize((size + BitmapWordBits - 1) / BitmapWordBits, 0);
+			_size = size;
+
+			// clear bits beyond size in the last word, so they'll be unused if we grow again
+			if (size % BitmapWordBits)
+			{
+				_words.back() &= (BitmapWord(1) << (size % BitmapWordBits)) - 1;
+			}
+		}
+
+		template <typename Allocator>
+		size_t OccupancyBitmap<Allocator>::find_next(size_t from, size_t end) const
+		{
+			if (from >= end)
+			{
+				return end;
+			}
+
+			// check first word (ignoring bits before 'from'), then skip empty words
+			size_t word_index = from / BitmapWordBits;
+			size_t last_word_index = (end - 1) / BitmapWordBits;
+			BitmapWord word = _words[word_index] & (~BitmapWord(0) << (from % BitmapWordBits));
+			while (!word)
+			{
+				if (++word_index > last_word_index)
+				{
+					return end;
+				}
+				word = _words[word_index];
+			}
+
+			// found a used index, but it might be beyond end
+			size_t index = word_index * BitmapWordBits + lowest_set_bit(word);
+			return index < end ? index : end;
+		}
+
+		template <typename Allocator>
+		size_t OccupancyBitmap<Allocator>::find_last(size_t from) const
+		{
+			// check first word (ignoring bits after 'from'), then skip empty words backwards
+			size_t word_index = from / BitmapWordBits;
+			BitmapWord word = _words[word_index] & (~BitmapWord(0) >> (BitmapWordBits - 1 - from % BitmapWordBits));
+			while (!word)
+			{
+				if (!word_index)
+				{
+					return 0;
+				}
+				word = _words[--word_index];
+			}
+			return word_index * BitmapWordBits + highest_set_bit(word);
+		}
+
+		template <typename Allocator>
+		template <typename Callback>
+		bool OccupancyBitmap<Allocator>::for_each_used(size_t begin, size_t end, Callback callback) const
+		{
+			if (begin >= end)
+			{
+				return true;
+			}
+
+			// go over the words in range, and call the callback for every set bit
+			size_t word_index = begin / BitmapWordBits;
+			size_t last_word_index = (end - 1) / BitmapWordBits;
+			BitmapWord word = _words[word_index] & (~BitmapWord(0) << (begin % BitmapWordBits));
+			while (true)
+			{
+				while (word)
+				{
+					size_t bit = lowest_set_bit(word);
+					size_t index = word_index * BitmapWordBits + bit;
+					if (index >= end)
+					{
+						return true;
+					}
+					if (!callback(index))
+					{
+						return false;
+					}
+
+					// read the word again rather than just clearing the bit, since callback might have released objects
+					word = (bit + 1 < BitmapWordBits) ? (_words[word_index] & (~BitmapWord(0) << (bit + 1))) : 0;
+				}
+
+				// skip to next word
+				if (++word_index > last_word_index)
+				{
+					return true;
+				}
+				word = _words[word_index];
+			}
+		}
+	}
+}
+
+#endif
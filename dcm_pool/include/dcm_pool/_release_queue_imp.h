@@ -0,0 +1,197 @@
+/*!
+* \file	include\dcm_pool\_release_queue_imp.h.
+*
+* \brief		Implement the ReleaseQueue class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include <thread>
+
+#ifndef __RELEASE_QUEUE_IMP__
+#define __RELEASE_QUEUE_IMP__
+
+namespace dcm_pool
+{
+	ReleaseQueue::ReleaseQueue() :
+		_tail(NULL),
+		_first(NULL),
+		_pushing(0),
+		_spare(NULL),
+		_head(NULL),
+		_head_drained(0),
+		_retired(NULL)
+	{
+	}
+
+	ReleaseQueue::~ReleaseQueue()
+	{
+		// free all blocks in queue (from the first block, if the consumer never started)
+		Block* block = _head ? _head : _first.load(std::memory_order_acquire);
+		while (block)
+		{
+			Block* next = block->next.load(std::memory_order_relaxed);
+			delete block;
+			block = next;
+		}
+
+		// free retired and spare blocks
+		while (_retired)
+		{
+			Block* next = _retired->retired_next;
+			delete _retired;
+			_retired = next;
+		}
+		delete _spare.load(std::memory_order_acquire);
+	}
+
+	void ReleaseQueue::Push(ObjectId id)
+	{
+		// while we push, the consumer will not reuse blocks (so any block we see stays valid)
+		_pushing.fetch_add(1, std::memory_order_seq_cst);
+
+		// first push ever? create the first block
+		Block* block = _tail.load(std::memory_order_seq_cst);
+		if (!block)
+		{
+			Block* first = NewBlock();
+			if (_tail.compare_exchange_strong(block, first, std::memory_order_seq_cst))
+			{
+				_first.store(first, std::memory_order_release);
+				block = first;
+			}
+			else
+			{
+				delete first;
+			}
+		}
+
+		while (true)
+		{
+			// claim a place in block. if we got one, write the id and we're done
+			size_t place = block->claimed.fetch_add(1, std::memory_order_relaxed);
+			if (place < ReleaseQueueBlockSize)
+			{
+				block->ids[place] = id;
+				block->written.fetch_add(1, std::memory_order_release);
+				break;
+			}
+
+			// block is full - move to the next block, and link a new one if there's none yet
+			Block* next = block->next.load(std::memory_order_acquire);
+			if (!next)
+			{
+				Block* created = NewBlock();
+				if (block->next.compare_exchange_strong(next, created, std::memory_order_acq_rel))
+				{
+					next = created;
+				}
+				else
+				{
+					// another producer linked a block first, keep ours as spare
+					Block* expected = NULL;
+					if (!_spare.compare_exchange_strong(expected, created, std::memory_order_acq_rel))
+					{
+						delete created;
+					}
+				}
+			}
+
+			// help other producers skip the full block
+			_tail.compare_exchange_strong(block, next, std::memory_order_seq_cst);
+			block = next;
+		}
+
+		_pushing.fetch_sub(1, std::memory_order_release);
+	}
+
+	template <typename Callback>
+	size_t ReleaseQueue::Drain(Callback&& callback)
+	{
+		// find the first block if we didn't start yet
+		if (!_head)
+		{
+			_head = _first.load(std::memory_order_acquire);
+			_head_drained = 0;
+			if (!_head)
+			{
+				return 0;
+			}
+		}
+
+		size_t count = 0;
+		while (true)
+		{
+			// wait for producers that claimed a place in block to finish writing their id (just a few instructions)
+			Block* block = _head;
+			size_t claimed = block->claimed.load(std::memory_order_acquire);
+			if (claimed > ReleaseQueueBlockSize)
+			{
+				claimed = ReleaseQueueBlockSize;
+			}
+			while (block->written.load(std::memory_order_acquire) < claimed)
+			{
+				std::this_thread::yield();
+			}
+
+			// take the new ids in block
+			while (_head_drained < claimed)
+			{
+				ObjectId id = block->ids[_head_drained++];
+				++count;
+				callback(id);
+			}
+
+			// stop at the last block
+			Block* next = block->next.load(std::memory_order_acquire);
+			if (claimed < ReleaseQueueBlockSize || !next)
+			{
+				break;
+			}
+
+			// block is done - make sure new producers no longer start from it, and retire it
+			Block* expected = block;
+			_tail.compare_exchange_strong(expected, next, std::memory_order_seq_cst);
+			block->retired_next = _retired;
+			_retired = block;
+			_head = next;
+			_head_drained = 0;
+		}
+
+		ReuseRetiredBlocks();
+		return count;
+	}
+
+	ReleaseQueue::Block* ReleaseQueue::NewBlock()
+	{
+		Block* block = _spare.exchange(NULL, std::memory_order_acq_rel);
+		return block ? block : new Block();
+	}
+
+	void ReleaseQueue::ReuseRetiredBlocks()
+	{
+		// producers that started pushing before the blocks were retired may still use them
+		if (!_retired || _pushing.load(std::memory_order_seq_cst) != 0)
+		{
+			return;
+		}
+
+		// keep one block as spare and free the rest
+		while (_retired)
+		{
+			Block* block = _retired;
+			_retired = block->retired_next;
+			block->claimed.store(0, std::memory_order_relaxed);
+			block->written.store(0, std::memory_order_relaxed);
+			block->next.store(NULL, std::memory_order_relaxed);
+			Block* expected = NULL;
+			if (!_spare.compare_exchange_strong(expected, block, std::memory_order_acq_rel))
+			{
+				delete block;
+			}
+		}
+	}
+}
+
+#endif
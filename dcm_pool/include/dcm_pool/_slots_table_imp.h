@@ -0,0 +1,97 @@
+/*!
+* \file	include\dcm_pool\_slots_table_imp.h.
+*
+* \brief		Implement the SlotsTable class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include "exceptions.h"
+
+#ifndef __SLOTS_TABLE_IMP__
+#define __SLOTS_TABLE_IMP__
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		template <typename Allocator, typename IdTraits>
+		ObjectId SlotsTable<Allocator, IdTraits>::alloc(size_t index)
+		{
+			// no free slots to reuse? add a new one
+			if (_first_free == IdTraits::InvalidIndex)
+			{
+				// make sure we don't exceed the slots we can represent in object id
+				if (_slots.size() >= IdTraits::SlotMask)
+				{
+					throw ExceededPoolLimit();
+				}
+
+				Slot new_slot;
+				new_slot.index = (typename IdTraits::Id)index;
+				new_slot.generation = 1;
+				_slots.push_back(new_slot);
+				return IdTraits::make_id(_slots.size() - 1, new_slot.generation);
+			}
+
+			// take the first free slot and set the next free slot as first
+			size_t slot_index = _first_free;
+			Slot& slot = _slots[slot_index];
+			_first_free = slot.index;
+			_free_count--;
+
+			// set index and move to next (used) generation
+			slot.index = (typename IdTraits::Id)index;
+			slot.generation = (typename IdTraits::Id)((slot.generation + 1) & IdTraits::GenerationMask);
+			return IdTraits::make_id(slot_index, slot.generation);
+		}
+
+		template <typename Allocator, typename IdTraits>
+		void SlotsTable<Allocator, IdTraits>::release(ObjectId id)
+		{
+			// move to next (free) generation, so this id will no longer be valid
+			size_t slot_index = IdTraits::get_slot(id);
+			Slot& slot = _slots[slot_index];
+			slot.generation = (typename IdTraits::Id)((slot.generation + 1) & IdTraits::GenerationMask);
+
+			// generation wrapped around? retire the slot, so ids from its previous generations never become valid again
+			if (slot.generation == 0)
+			{
+				return;
+			}
+
+			// push slot to the head of the free slots list
+			slot.index = (typename IdTraits::Id)_first_free;
+			_first_free = slot_index;
+			_free_count++;
+		}
+
+		template <typename Allocator, typename IdTraits>
+		void SlotsTable<Allocator, IdTraits>::clear()
+		{
+			// release all slots but keep their generations, so ids from before clearing remain invalid
+			_first_free = IdTraits::InvalidIndex;
+			_free_count = 0;
+			for (size_t i = _slots.size(); i-- > 0;)
+			{
+				Slot& slot = _slots[i];
+				if (slot.generation & 1)
+				{
+					slot.generation = (typename IdTraits::Id)((slot.generation + 1) & IdTraits::GenerationMask);
+				}
+
+				// skip retired slots (see release())
+				if (slot.generation == 0)
+				{
+					continue;
+				}
+				slot.index = (typename IdTraits::Id)_first_free;
+				_first_free = i;
+				_free_count++;
+			}
+		}
+	}
+}
+
+#endif
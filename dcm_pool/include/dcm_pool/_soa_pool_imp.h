@@ -0,0 +1,441 @@
+/*!
+* \file	include\dcm_pool\_soa_pool_imp.h.
+*
+* \brief		Implement the DcmSoaPool template class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include "exceptions.h"
+
+
+#ifndef __SOA_POOL_IMP__
+#define __SOA_POOL_IMP__
+
+
+namespace dcm_pool
+{
+	template <typename... Fields>
+	DcmSoaPool<Fields...>::DcmSoaPool(size_t max_size, size_t reserve, size_t shrink_threshold, DefragModes defrag_mode) :
+		_holes(_ids),
+		_max_size(max_size),
+		_allocated_objects_count(0),
+		_max_used_index_in_vector(0),
+		_shrink_pool_threshold(shrink_threshold),
+		_defrag_mode(defrag_mode),
+		_defrags_count(0),
+		_releases_count(0),
+		_first_hole(ObjectPoolMaxIndex)
+	{
+		// pre-alloc desired size
+		if (reserve)
+		{
+			Reserve(reserve);
+		}
+	}
+
+	template <typename... Fields>
+	typename DcmSoaPool<Fields...>::Ptr DcmSoaPool<Fields...>::Alloc()
+	{
+		// make sure didn't exceed pool limit, and that we have a slot for the new object's id
+		if ((_max_size && _allocated_objects_count >= _max_size) || !_slots.available())
+		{
+			throw ExceededPoolLimit();
+		}
+
+		// will hole the index to allocate from
+		std::size_t alloc_index;
+
+		// do we have a hole to fill? if so, use it (unless we keep allocation order)
+		while (_holes.size() && _defrag_mode != DEFRAG_STABLE)
+		{
+			// get index to alloc on and remove from holes vector
+			alloc_index = _holes.pop_back();
+
+			// holes beyond max used index are leftovers from releasing the last objects, skip them
+			if (alloc_index >= _max_used_index_in_vector)
+			{
+				continue;
+			}
+
+			// return the new object pointer
+			return AssignObject(alloc_index);
+		}
+
+		// do we have unused objects at the end of the columns? fill them
+		alloc_index = _allocated_objects_count ? _max_used_index_in_vector + 1 : 0;
+		if (alloc_index < _ids.size())
+		{
+			return AssignObject(alloc_index);
+		}
+
+		// if we got here it means we don't have any hole to fill, and must add a new object to all columns
+		GrowColumns(std::index_sequence_for<Fields...>());
+		_ids.push_back(ObjectPoolMaxIndex);
+		_is_used.push_back(false);
+		return AssignObject(alloc_index);
+	}
+
+	template <typename... Fields>
+	typename DcmSoaPool<Fields...>::Ptr DcmSoaPool<Fields...>::AssignObject(size_t index)
+	{
+		// increase allocated objects count
+		_allocated_objects_count++;
+
+		// update max used index, if needed
+		if (index > _max_used_index_in_vector)
+		{
+			_max_used_index_in_vector = index;
+		}
+
+		// get id and set as used
+		ObjectId id = _slots.alloc(index);
+		_ids[index] = id;
+		_is_used.set(index);
+
+		// create a pointer to return
+		Ptr ret(this, id);
+		ret._set_cached_index(index, _defrags_count, _releases_count);
+
+		// if defined, call the OnAlloc event handler
+		if (OnAlloc) OnAlloc(id, *this);
+
+		// return the object
+		return ret;
+	}
+
+	template <typename... Fields>
+	size_t DcmSoaPool<Fields...>::_get_index(ObjectId id) const
+	{
+		// make sure id belongs to a used object
+		if (!_slots.is_alive(id))
+		{
+			throw AccessViolation();
+		}
+
+		return _slots.get_index(id);
+	}
+
+	template <typename... Fields>
+	bool DcmSoaPool<Fields...>::IsAlive(ObjectId id) const
+	{
+		return _slots.is_alive(id);
+	}
+
+	template <typename... Fields>
+	template <size_t Column>
+	typename DcmSoaPool<Fields...>::template ColumnType<Column>& DcmSoaPool<Fields...>::Get(ObjectId id)
+	{
+		return std::get<Column>(_columns)[_get_index(id)];
+	}
+
+	template <typename... Fields>
+	template <size_t Column>
+	typename DcmSoaPool<Fields...>::template ColumnType<Column>* DcmSoaPool<Fields...>::TryGet(ObjectId id)
+	{
+		return _slots.is_alive(id) ? &std::get<Column>(_columns)[_slots.get_index(id)] : NULL;
+	}
+
+	template <typename... Fields>
+	template <size_t Column>
+	typename DcmSoaPool<Fields...>::template ColumnType<Column>* DcmSoaPool<Fields...>::GetColumn()
+	{
+		return std::get<Column>(_columns).data();
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Release(typename DcmSoaPool<Fields...>::Ptr obj)
+	{
+		Release(obj._get_id());
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Release(ObjectId id)
+	{
+		// get object index in pool (will throw if not a valid object) and release it
+		ReleaseAt(_get_index(id), id);
+	}
+
+	template <typename... Fields>
+	bool DcmSoaPool<Fields...>::TryRelease(ObjectId id)
+	{
+		// not a used object? skip
+		if (!_slots.is_alive(id))
+		{
+			return false;
+		}
+
+		ReleaseAt(_slots.get_index(id), id);
+		return true;
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::ReleaseAt(size_t index, ObjectId id)
+	{
+		// if defined, call the OnRelease event handler
+		if (OnRelease) OnRelease(id, *this);
+
+		// first, free the object slot (pointers that cached an index since the last release will check their id again)
+		_slots.release(id);
+		_releases_count++;
+
+		// now decrease actual pool size
+		_allocated_objects_count--;
+
+		// set as no longer used
+		_is_used.reset(index);
+
+		// if we happened to release the last object in pool, its the easier case - we just decrease the used index as well
+		// note: we skip holes we might have before it, so max used index will always point on a used object
+		if (index == _max_used_index_in_vector)
+		{
+			_max_used_index_in_vector = _is_used.find_last(_max_used_index_in_vector);
+
+			// if pool is now empty there are no holes to close
+			if (!_allocated_objects_count)
+			{
+				_holes.clear();
+				_first_hole = ObjectPoolMaxIndex;
+			}
+			return;
+		}
+
+		// if got here it means we created a hole. add it to holes vector.
+		// in stable mode we only need the first hole (and new objects at the end of columns would override holes list links)
+		if (_defrag_mode == DEFRAG_STABLE)
+		{
+			if (index < _first_hole)
+			{
+				_first_hole = index;
+			}
+			return;
+		}
+		_holes.push_back(index);
+
+		// if in immediate defrag mode, do it now
+		if (_defrag_mode == DEFRAG_IMMEDIATE)
+		{
+			Defrag();
+		}
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Clear()
+	{
+		_slots.clear();
+		_releases_count++;
+		ClearColumns(std::index_sequence_for<Fields...>());
+		_ids.clear();
+		_is_used.clear();
+		_holes.clear();
+		_first_hole = ObjectPoolMaxIndex;
+		_allocated_objects_count = 0;
+		_max_used_index_in_vector = 0;
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Defrag()
+	{
+		// no holes to fill? nothing to do here
+		if (!_holes.size() && _first_hole == ObjectPoolMaxIndex)
+		{
+			return;
+		}
+
+		// increase defragging count
+		_defrags_count++;
+
+		// in stable mode, shift objects back over the holes to keep their order
+		if (_defrag_mode == DEFRAG_STABLE)
+		{
+			CompactStable();
+		}
+
+		// iterate and close holes until we no longer have holes to close
+		while (_holes.size())
+		{
+			// get current index to move
+			auto index_to_fill = _holes.pop_back();
+
+			// if index to fill is outside max used index, skip
+			if (index_to_fill >= _max_used_index_in_vector)
+			{
+				continue;
+			}
+
+			// move last object into this position, in all columns
+			MoveObject(_max_used_index_in_vector, index_to_fill, std::index_sequence_for<Fields...>());
+			_ids[index_to_fill] = _ids[_max_used_index_in_vector];
+			_is_used.set(index_to_fill);
+			_is_used.reset(_max_used_index_in_vector);
+
+			// update max used index
+			_max_used_index_in_vector = _is_used.find_last(_max_used_index_in_vector);
+
+			// update the slots table
+			_slots.set_index(_ids[index_to_fill], index_to_fill);
+		}
+
+		// check if we need to resize columns
+		if (_ids.size() - _max_used_index_in_vector > _shrink_pool_threshold)
+		{
+			ClearUnusedMemory();
+		}
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::CompactStable()
+	{
+		// get the first hole (it might have been filled since, if objects after it were released and new ones allocated)
+		size_t write = _first_hole;
+		_first_hole = ObjectPoolMaxIndex;
+		while (write < _max_used_index_in_vector && _is_used[write])
+		{
+			write++;
+		}
+
+		// no holes before the last object?
+		if (write >= _max_used_index_in_vector)
+		{
+			return;
+		}
+
+		// shift every object after the first hole back, so objects keep their order (like std::remove_if)
+		_is_used.for_each_used(write + 1, _max_used_index_in_vector + 1, [&](size_t read)
+		{
+			MoveObject(read, write, std::index_sequence_for<Fields...>());
+			_ids[write] = _ids[read];
+			_is_used.set(write);
+			_is_used.reset(read);
+			_slots.set_index(_ids[write], write);
+			write++;
+			return true;
+		});
+
+		// update max used index
+		_max_used_index_in_vector = write - 1;
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Reserve(size_t amount)
+	{
+		ReserveColumns(amount, std::index_sequence_for<Fields...>());
+		_ids.reserve(amount);
+		_is_used.reserve(amount);
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::Iterate(SoaPoolIterator<Fields...> callback)
+	{
+		IterateAllColumns(callback, std::index_sequence_for<Fields...>());
+	}
+
+	template <typename... Fields>
+	template <size_t... Columns, typename Callback>
+	void DcmSoaPool<Fields...>::IterateColumns(Callback callback)
+	{
+		// if in deferred defrag mode, do it now.
+		// columns are iterated as plain arrays without checking for holes, so DEFRAG_INCREMENTAL closes all holes here too
+		// (in DEFRAG_IMMEDIATE mode holes are closed as soon as they are created)
+		if (_defrag_mode == DEFRAG_DEFERRED || _defrag_mode == DEFRAG_STABLE || _defrag_mode == DEFRAG_INCREMENTAL)
+		{
+			Defrag();
+		}
+
+		// nothing to iterate?
+		if (!_allocated_objects_count)
+		{
+			return;
+		}
+
+		// iterate all objects, there are no holes to skip
+		for (size_t i = 0; i <= _max_used_index_in_vector; ++i)
+		{
+			callback(std::get<Columns>(_columns)[i]..., _ids[i]);
+		}
+	}
+
+	template <typename... Fields>
+	void DcmSoaPool<Fields...>::ClearUnusedMemory()
+	{
+		// make sure there are not holes
+		if (_holes.size() || (_allocated_objects_count && _allocated_objects_count != _max_used_index_in_vector + 1))
+		{
+			throw CannotResizeWhileNotDefragged();
+		}
+		_first_hole = ObjectPoolMaxIndex;
+
+		// resize columns
+		size_t new_size = _max_used_index_in_vector + 1;
+		ResizeColumns(new_size, std::index_sequence_for<Fields...>());
+		_ids.resize(new_size);
+		_is_used.resize(new_size);
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::IterateAllColumns(SoaPoolIterator<Fields...> callback, std::index_sequence<I...>)
+	{
+		IterateColumns<I...>(callback);
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::GrowColumns(std::index_sequence<I...>)
+	{
+		int expand[] = { 0, ((void)std::get<I>(_columns).emplace_back(), 0)... };
+		(void)expand;
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::ResizeColumns(size_t new_size, std::index_sequence<I...>)
+	{
+		int expand[] = { 0, ((void)std::get<I>(_columns).resize(new_size), 0)... };
+		(void)expand;
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::ReserveColumns(size_t amount, std::index_sequence<I...>)
+	{
+		int expand[] = { 0, ((void)std::get<I>(_columns).reserve(amount), 0)... };
+		(void)expand;
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::ClearColumns(std::index_sequence<I...>)
+	{
+		int expand[] = { 0, ((void)std::get<I>(_columns).clear(), 0)... };
+		(void)expand;
+	}
+
+	template <typename... Fields>
+	template <size_t... I>
+	void DcmSoaPool<Fields...>::MoveObject(size_t from, size_t to, std::index_sequence<I...>)
+	{
+		int expand[] = { 0, ((void)(std::get<I>(_columns)[to] = std::move(std::get<I>(_columns)[from])), 0)... };
+		(void)expand;
+	}
+
+	template <typename... Fields>
+	template <size_t Column>
+	typename DcmSoaPool<Fields...>::template ColumnType<Column>& DcmSoaPool<Fields...>::Ptr::Get()
+	{
+		// check if we have a valid cached index to use, if not get the index and cache it.
+		// objects move only on defrag, but if objects were released since we cached it ours might be one of them,
+		// so we check the id again (this will throw if object was released)
+		if (_pool_defrag_version != _pool->_get_defrags_count() || _pool_releases_count != _pool->_get_releases_count())
+		{
+			_cached_index = _pool->_get_index(_id);
+			_pool_defrag_version = _pool->_get_defrags_count();
+			_pool_releases_count = _pool->_get_releases_count();
+		}
+
+		return _pool->template GetColumn<Column>()[_cached_index];
+	}
+}
+
+#endif // !__SOA_POOL_IMP__
@@ -0,0 +1,250 @@
+/*!
+* \file	include\dcm_pool\_systems_scheduler_imp.h.
+*
+* \brief		Implement the SystemsScheduler class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include <algorithm>
+
+#ifndef __SYSTEMS_SCHEDULER_IMP__
+#define __SYSTEMS_SCHEDULER_IMP__
+
+namespace dcm_pool
+{
+	SystemsScheduler::SystemsScheduler(ThreadPool& workers) :
+		_workers(workers),
+		_pending_systems(0),
+		_abort(false),
+		_idle_workers(0),
+		_tasks_version(0)
+	{
+		// create a tasks queue per worker
+		for (size_t i = 0; i < _workers.size(); ++i)
+		{
+			_queues.push_back(std::unique_ptr<_internal::WorkStealingQueue>(new _internal::WorkStealingQueue()));
+		}
+	}
+
+	template <typename Pool, typename Callback>
+	size_t SystemsScheduler::AddSystem(Pool& pool, const Callback& callback, std::initializer_list<const void*> reads, std::initializer_list<const void*> writes, size_t grain)
+	{
+		// create system state
+		std::unique_ptr<SystemState> state(new SystemState());
+		state->system.reset(new _internal::PoolSystem<Pool, Callback>(pool, callback, grain));
+		state->reads.assign(reads.begin(), reads.end());
+		state->writes.assign(writes.begin(), writes.end());
+		state->writes.push_back((const void*)&pool);
+		state->dependencies_count = 0;
+
+		// wait for all previous systems we conflict with
+		size_t index = _systems.size();
+		for (size_t i = 0; i < index; ++i)
+		{
+			if (Conflicts(*_systems[i], *state))
+			{
+				_systems[i]->dependents.push_back(index);
+				state->dependencies_count++;
+			}
+		}
+
+		// add system
+		_systems.push_back(std::move(state));
+		return index;
+	}
+
+	void SystemsScheduler::Run()
+	{
+		// nothing to do?
+		if (_systems.empty())
+		{
+			return;
+		}
+
+		// reset run state
+		_abort.store(false);
+		_pending_systems.store(_systems.size());
+		for (size_t i = 0; i < _systems.size(); ++i)
+		{
+			_systems[i]->pending_dependencies.store(_systems[i]->dependencies_count);
+			_systems[i]->stopped.store(false);
+		}
+
+		try
+		{
+			// start all systems that don't wait for anything, spread over workers
+			size_t worker = 0;
+			for (size_t i = 0; i < _systems.size(); ++i)
+			{
+				if (_systems[i]->dependencies_count == 0)
+				{
+					StartSystem(i, worker);
+					worker = (worker + 1) % _queues.size();
+				}
+			}
+
+			// run all workers until all systems are done
+			_workers.ParallelFor(_queues.size(), [this](size_t queue) { WorkerLoop(queue); });
+		}
+		catch (...)
+		{
+			// leave queues empty for next run
+			for (size_t i = 0; i < _queues.size(); ++i)
+			{
+				_queues[i]->clear();
+			}
+			throw;
+		}
+	}
+
+	void SystemsScheduler::StartSystem(size_t system, size_t worker)
+	{
+		// prepare pool and get how many chunks to run
+		SystemState& state = *_systems[system];
+		size_t chunks = state.system->prepare(_workers.size());
+
+		// empty pool? system is already done
+		if (chunks == 0)
+		{
+			FinishSystem(system, worker);
+			return;
+		}
+
+		// queue chunks. pushed in reverse, so owner pops them in order while thieves take from the end
+		state.pending_chunks.store(chunks);
+		for (size_t i = chunks; i > 0; --i)
+		{
+			_internal::SchedulerTask task;
+			task.system = system;
+			task.chunk = i - 1;
+			_queues[worker]->push(task);
+		}
+		WakeIdleWorkers(true);
+	}
+
+	void SystemsScheduler::FinishSystem(size_t system, size_t worker)
+	{
+		// start dependents that were waiting only for this system
+		SystemState& state = *_systems[system];
+		for (size_t i = 0; i < state.dependents.size(); ++i)
+		{
+			size_t dependent = state.dependents[i];
+			if (_systems[dependent]->pending_dependencies.fetch_sub(1) == 1)
+			{
+				StartSystem(dependent, worker);
+			}
+		}
+
+		// one less system to wait for. if it was the last one, let idle workers exit
+		if (_pending_systems.fetch_sub(1) == 1)
+		{
+			WakeIdleWorkers(false);
+		}
+	}
+
+	void SystemsScheduler::WorkerLoop(size_t worker)
+	{
+		// how many times in a row we found nothing to do
+		size_t idle_rounds = 0;
+		while (_pending_systems.load() > 0 && !_abort.load(std::memory_order_relaxed))
+		{
+			// remember which tasks were queued before we look, so we don't sleep through tasks queued while looking
+			size_t tasks_version = _tasks_version.load();
+
+			// take a task from our own queue, or steal one from other workers
+			_internal::SchedulerTask task;
+			bool found = _queues[worker]->pop(task);
+			for (size_t i = 1; !found && i < _queues.size(); ++i)
+			{
+				found = _queues[(worker + i) % _queues.size()]->steal(task);
+			}
+
+			// nothing to do right now? other workers are running the last chunks, or starting new systems.
+			// retry a few times (new tasks usually come soon), then sleep until they queue new tasks or finish
+			if (!found)
+			{
+				if (++idle_rounds < SchedulerIdleRoundsBeforeSleep)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(_idle_mutex);
+				_idle_workers++;
+				_idle_condition.wait(lock, [this, tasks_version]() {
+					return _tasks_version.load() != tasks_version || _pending_systems.load() == 0 || _abort.load(); });
+				_idle_workers--;
+				idle_rounds = 0;
+				continue;
+			}
+			idle_rounds = 0;
+
+			// run the chunk (unless callback already returned ITER_BREAK). if it throws, stop all workers
+			SystemState& state = *_systems[task.system];
+			try
+			{
+				if (!state.stopped.load(std::memory_order_relaxed) && !state.system->run_chunk(task.chunk))
+				{
+					state.stopped.store(true, std::memory_order_relaxed);
+				}
+
+				// was it the system's last chunk?
+				if (state.pending_chunks.fetch_sub(1) == 1)
+				{
+					FinishSystem(task.system, worker);
+				}
+			}
+			catch (...)
+			{
+				_abort.store(true);
+				WakeIdleWorkers(false);
+				throw;
+			}
+		}
+	}
+
+	void SystemsScheduler::WakeIdleWorkers(bool new_tasks)
+	{
+		// change state under the lock, so a worker can't check it and then miss the notification before it sleeps
+		bool any_idle;
+		{
+			std::lock_guard<std::mutex> lock(_idle_mutex);
+			if (new_tasks)
+			{
+				_tasks_version.fetch_add(1);
+			}
+			any_idle = _idle_workers > 0;
+		}
+
+		// notify only if someone sleeps (workers that are still retrying will see the new state on their own)
+		if (any_idle)
+		{
+			_idle_condition.notify_all();
+		}
+	}
+
+	bool SystemsScheduler::Conflicts(const SystemState& first, const SystemState& second)
+	{
+		// check if one system writes something the other reads or writes
+		for (size_t i = 0; i < first.writes.size(); ++i)
+		{
+			const void* resource = first.writes[i];
+			if (std::find(second.writes.begin(), second.writes.end(), resource) != second.writes.end() ||
+				std::find(second.reads.begin(), second.reads.end(), resource) != second.reads.end())
+			{
+				return true;
+			}
+		}
+		for (size_t i = 0; i < second.writes.size(); ++i)
+		{
+			if (std::find(first.reads.begin(), first.reads.end(), second.writes[i]) != first.reads.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+#endif
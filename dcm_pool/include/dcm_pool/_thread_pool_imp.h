@@ -0,0 +1,185 @@
+/*!
+* \file	include\dcm_pool\_thread_pool_imp.h.
+*
+* \brief		Implement the ThreadPool class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include <memory>
+
+#ifndef __THREAD_POOL_IMP__
+#define __THREAD_POOL_IMP__
+
+namespace dcm_pool
+{
+	ThreadPool::ThreadPool(size_t threads_count) :
+		_task(NULL),
+		_task_context(NULL),
+		_tasks_count(0),
+		_next_task(0),
+		_busy_workers(0),
+		_batch_id(0),
+		_stop(false)
+	{
+		// use all hardware threads by default
+		if (!threads_count)
+		{
+			threads_count = std::thread::hardware_concurrency();
+		}
+
+		// create workers (calling thread is the extra one)
+		for (size_t i = 1; i < threads_count; ++i)
+		{
+			_workers.push_back(std::thread([this]() { WorkerLoop(); }));
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		// tell workers to stop and wait for them
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_wake_workers.notify_all();
+		for (size_t i = 0; i < _workers.size(); ++i)
+		{
+			_workers[i].join();
+		}
+	}
+
+	template <typename Callback>
+	void ThreadPool::ParallelFor(size_t tasks_count, Callback&& callback)
+	{
+		typedef typename std::remove_reference<Callback>::type CallbackType;
+		Run(tasks_count, [](void* context, size_t task) { (*static_cast<CallbackType*>(context))(task); }, (void*)std::addressof(callback));
+	}
+
+	ThreadPool& ThreadPool::Default()
+	{
+		static ThreadPool default_pool;
+		return default_pool;
+	}
+
+	void ThreadPool::Run(size_t tasks_count, void(*task)(void*, size_t), void* context)
+	{
+		// no workers, or a task started a new batch? just run it on this thread
+		if (_workers.empty() || InsideTask())
+		{
+			for (size_t i = 0; i < tasks_count; ++i)
+			{
+				task(context, i);
+			}
+			return;
+		}
+
+		// nothing to do?
+		if (!tasks_count)
+		{
+			return;
+		}
+
+		// set the new batch and wake up workers
+		std::lock_guard<std::mutex> batch_lock(_batch_mutex);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_task = task;
+			_task_context = context;
+			_tasks_count = tasks_count;
+			_next_task.store(0);
+			_busy_workers = _workers.size();
+			_exception = NULL;
+			_batch_id++;
+		}
+		_wake_workers.notify_all();
+
+		// calling thread works too
+		InsideTask() = true;
+		RunTasks();
+		InsideTask() = false;
+
+		// wait for workers to finish
+		std::exception_ptr exception;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_batch_done.wait(lock, [this]() { return _busy_workers == 0; });
+			exception = _exception;
+			_exception = NULL;
+		}
+
+		// rethrow first exception a task threw
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void ThreadPool::RunTasks()
+	{
+		while (true)
+		{
+			// take next task
+			size_t task = _next_task.fetch_add(1, std::memory_order_relaxed);
+			if (task >= _tasks_count)
+			{
+				return;
+			}
+
+			// run it. if it throws, keep the exception and skip the rest of the tasks
+			try
+			{
+				_task(_task_context, task);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (!_exception)
+				{
+					_exception = std::current_exception();
+				}
+				_next_task.store(_tasks_count);
+			}
+		}
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		InsideTask() = true;
+		size_t last_batch_id = 0;
+		while (true)
+		{
+			// wait for a new batch (or stop)
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_wake_workers.wait(lock, [&]() { return _stop || _batch_id != last_batch_id; });
+				if (_stop)
+				{
+					return;
+				}
+				last_batch_id = _batch_id;
+			}
+
+			// run tasks
+			RunTasks();
+
+			// let the calling thread know we're done
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (--_busy_workers == 0)
+				{
+					_batch_done.notify_one();
+				}
+			}
+		}
+	}
+
+	bool& ThreadPool::InsideTask()
+	{
+		static thread_local bool inside_task = false;
+		return inside_task;
+	}
+}
+
+#endif
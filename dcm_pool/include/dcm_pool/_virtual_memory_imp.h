@@ -0,0 +1,171 @@
+/*!
+* \file	include\dcm_pool\_virtual_memory_imp.h.
+*
+* \brief		Implement the virtual memory helpers for Windows and POSIX.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#include <new>
+#include <cstdio>
+
+#ifndef __VIRTUAL_MEMORY_IMP__
+#define __VIRTUAL_MEMORY_IMP__
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		size_t get_virtual_page_size()
+		{
+#ifdef _WIN32
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return (size_t)info.dwPageSize;
+#else
+			return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+		}
+
+		void* reserve_virtual_memory(size_t bytes)
+		{
+#ifdef _WIN32
+			void* ret = VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+			if (ret == NULL)
+			{
+				throw std::bad_alloc();
+			}
+#else
+			void* ret = mmap(NULL, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if (ret == MAP_FAILED)
+			{
+				throw std::bad_alloc();
+			}
+#endif
+			return ret;
+		}
+
+		void* reserve_huge_pages_memory(size_t bytes, bool& explicit_huge_pages)
+		{
+			explicit_huge_pages = false;
+
+#ifdef _WIN32
+			// large pages on windows must be committed up front and require special privileges, so we use a regular range
+			return reserve_virtual_memory(bytes);
+#else
+	#ifdef MAP_HUGETLB
+			// first try explicit huge pages. note: no MAP_NORESERVE, so we fail here and not on first touch if pool is too small
+			void* ret = mmap(NULL, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (ret != MAP_FAILED)
+			{
+				explicit_huge_pages = true;
+				return ret;
+			}
+	#endif
+
+			// fall back to a regular range aligned to huge page size, so transparent huge pages can cover it fully
+			char* raw = (char*)reserve_virtual_memory(bytes + HugePageSize);
+			char* aligned = (char*)(((size_t)raw + HugePageSize - 1) & ~(HugePageSize - 1));
+			if (aligned > raw)
+			{
+				munmap(raw, aligned - raw);
+			}
+			munmap(aligned + bytes, (raw + bytes + HugePageSize) - (aligned + bytes));
+	#ifdef MADV_HUGEPAGE
+			madvise(aligned, bytes, MADV_HUGEPAGE);
+	#endif
+			return aligned;
+#endif
+		}
+
+		size_t get_huge_pages_bytes(void* address, size_t bytes)
+		{
+#ifdef __linux__
+			FILE* smaps = fopen("/proc/self/smaps", "r");
+			if (!smaps)
+			{
+				return 0;
+			}
+
+			// sum huge pages of all the mappings inside the range (committing splits the range into several mappings)
+			size_t begin = (size_t)address;
+			size_t end = begin + bytes;
+			size_t ret = 0;
+			bool in_range = false;
+			char line[256];
+			while (fgets(line, sizeof(line), smaps))
+			{
+				unsigned long long from, to;
+				size_t kb;
+				if (sscanf(line, "%llx-%llx ", &from, &to) == 2)
+				{
+					in_range = from >= begin && to <= end;
+				}
+				else if (in_range && (sscanf(line, "AnonHugePages: %zu kB", &kb) == 1 || sscanf(line, "Private_Hugetlb: %zu kB", &kb) == 1))
+				{
+					ret += kb * 1024;
+				}
+			}
+			fclose(smaps);
+			return ret;
+#else
+			(void)address;
+			(void)bytes;
+			return 0;
+#endif
+		}
+
+		void commit_virtual_memory(void* address, size_t bytes)
+		{
+#ifdef _WIN32
+			if (VirtualAlloc(address, bytes, MEM_COMMIT, PAGE_READWRITE) == NULL)
+			{
+				throw std::bad_alloc();
+			}
+#else
+			// note: physical pages are only mapped on first touch
+			if (mprotect(address, bytes, PROT_READ | PROT_WRITE) != 0)
+			{
+				throw std::bad_alloc();
+			}
+#endif
+		}
+
+		void decommit_virtual_memory(void* address, size_t bytes)
+		{
+#ifdef _WIN32
+			VirtualFree(address, bytes, MEM_DECOMMIT);
+#else
+			// drop the physical pages, and make the range inaccessible again like a fresh reservation
+			madvise(address, bytes, MADV_DONTNEED);
+			mprotect(address, bytes, PROT_NONE);
+#endif
+		}
+
+		void release_virtual_memory(void* address, size_t bytes)
+		{
+#ifdef _WIN32
+			(void)bytes;
+			VirtualFree(address, 0, MEM_RELEASE);
+#else
+			munmap(address, bytes);
+#endif
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*!
+* \file	include\dcm_pool\concurrent_free_stack.h.
+*
+* \brief		An internal lock-free stack of free indices, used by the concurrent pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "concurrent_pages.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	ConcurrentFreeStack
+		*
+		* \brief	A lock-free stack of free indices (used instead of HolesList in the concurrent pool).
+		* 			Like HolesList, it doesn't use any additional memory: links are stored in the free elements themselves,
+		* 			via links.free_link(index) which returns a std::atomic<size_t>&.
+		* 			The head holds a tag that changes on every push and pop, so a thread that read the head before other
+		* 			threads popped and pushed the same index back will fail to update it (the ABA problem).
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*/
+		class ConcurrentFreeStack
+		{
+		private:
+
+			// head: upper 32 bits are the tag, lower 32 bits are first free index + 1 (0 for empty stack).
+			alignas(ConcurrentCacheLineSize) std::atomic<uint64_t> _head;
+
+			// mask to extract index + 1 from head.
+			static const uint64_t IndexMask = 0xffffffffull;
+
+		public:
+
+			/*! \brief	Max index the stack can hold. */
+			static const size_t MaxIndex = 0xfffffffe;
+
+			/*! \brief	Constructor. */
+			ConcurrentFreeStack() : _head(0) { }
+
+			/*! \brief	Push a free index. */
+			template <typename Links>
+			inline void push(size_t index, Links& links) { push_chain(index, index, links); }
+
+			/*! \brief	Push a chain of free indices that are already linked to each other (from first to last), with a single update. */
+			template <typename Links>
+			inline void push_chain(size_t first, size_t last, Links& links)
+			{
+				uint64_t head = _head.load(std::memory_order_relaxed);
+				uint64_t new_head;
+				do
+				{
+					links.free_link(last).store(size_t(head & IndexMask), std::memory_order_relaxed);
+					new_head = (((head >> 32) + 1) << 32) | uint64_t(first + 1);
+				} while (!_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+			}
+
+			/*! \brief	Pop a free index, or return ObjectPoolMaxIndex if empty. */
+			template <typename Links>
+			inline size_t pop(Links& links)
+			{
+				uint64_t head = _head.load(std::memory_order_acquire);
+				while (head & IndexMask)
+				{
+					size_t index = size_t(head & IndexMask) - 1;
+					uint64_t next = uint64_t(links.free_link(index).load(std::memory_order_relaxed)) & IndexMask;
+					uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+					if (_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+					{
+						return index;
+					}
+				}
+				return ObjectPoolMaxIndex;
+			}
+
+			/*! \brief	Take all free indices at once. Returns the first index of the chain, or ObjectPoolMaxIndex if empty. */
+			inline size_t take_all()
+			{
+				uint64_t head = _head.load(std::memory_order_acquire);
+				while (head & IndexMask)
+				{
+					if (_head.compare_exchange_weak(head, ((head >> 32) + 1) << 32, std::memory_order_acquire, std::memory_order_acquire))
+					{
+						return size_t(head & IndexMask) - 1;
+					}
+				}
+				return ObjectPoolMaxIndex;
+			}
+
+			/*! \brief	Is the stack empty. */
+			inline bool empty() const { return (_head.load(std::memory_order_relaxed) & IndexMask) == 0; }
+
+			/*! \brief	Remove all indices (only when no other thread uses the stack). */
+			inline void clear() { _head.store(_head.load(std::memory_order_relaxed) & ~IndexMask, std::memory_order_relaxed); }
+		};
+
+		/*!
+		* \class	LocalFreeList
+		*
+		* \brief	A free indices list owned by a single thread, linked the same way as ConcurrentFreeStack, so chains can
+		* 			move between them in bulk: take a whole stack with take_all(), or publish the whole list with flush().
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*/
+		class LocalFreeList
+		{
+		private:
+
+			// first free index, or ObjectPoolMaxIndex if empty.
+			size_t _first;
+
+		public:
+
+			/*! \brief	Constructor. */
+			LocalFreeList() : _first(ObjectPoolMaxIndex) { }
+
+			/*! \brief	Is the list empty. */
+			inline bool empty() const { return _first == ObjectPoolMaxIndex; }
+
+			/*! \brief	Push a free index. */
+			template <typename Links>
+			inline void push(size_t index, Links& links)
+			{
+				links.free_link(index).store(empty() ? 0 : _first + 1, std::memory_order_relaxed);
+				_first = index;
+			}
+
+			/*! \brief	Pop a free index, or return ObjectPoolMaxIndex if empty. */
+			template <typename Links>
+			inline size_t pop(Links& links)
+			{
+				size_t index = _first;
+				if (index != ObjectPoolMaxIndex)
+				{
+					_first = links.free_link(index).load(std::memory_order_relaxed) - 1;
+				}
+				return index;
+			}
+
+			/*! \brief	Set the list to a chain taken from ConcurrentFreeStack::take_all(). List must be empty. */
+			inline void take(size_t first) { _first = first; }
+
+			/*! \brief	Move all indices to a shared stack, with a single update of the stack. */
+			template <typename Links>
+			inline void flush(ConcurrentFreeStack& stack, Links& links)
+			{
+				if (empty()) { return; }
+				size_t last = _first;
+				for (size_t next; (next = links.free_link(last).load(std::memory_order_relaxed)) != 0;)
+				{
+					last = next - 1;
+				}
+				stack.push_chain(_first, last, links);
+				_first = ObjectPoolMaxIndex;
+			}
+		};
+	}
+}
@@ -0,0 +1,164 @@
+/*!
+* \file	include\dcm_pool\concurrent_pages.h.
+*
+* \brief		An internal paged array that can grow while other threads access it, used by the concurrent pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "occupancy_bitmap.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*! \brief	Cache line size, used to keep atomics that different threads update often on separate lines. */
+		const size_t ConcurrentCacheLineSize = 64;
+
+		/*! \brief	Size of the first page in concurrent pages (as shift). Every page is twice the size of the previous one. */
+		const size_t ConcurrentFirstPageShift = 6;
+
+		/*! \brief	Max pages count in concurrent pages (enough to cover every index we can represent). */
+		const size_t ConcurrentPagesCount = sizeof(size_t) * 8 - ConcurrentFirstPageShift;
+
+		/*!
+		* \class	ConcurrentPages
+		*
+		* \brief	An internal array of elements stored in pages, that can grow while other threads read it.
+		* 			Page N holds (64 << N) elements, so a small fixed table of page pointers covers every possible index,
+		* 			and the page of an index is found with a single bit scan. Pages are allocated the first time one of
+		* 			their indices is used, and are never moved or freed until the array is destroyed, so references to
+		* 			elements remain valid while other threads add pages.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Element				Type of elements to store.
+		* \tparam	Allocator			Allocator to use for pages memory (rebound to Element).
+		* \tparam	ConstructElements	If true, elements are value-initialized when their page is allocated and destroyed with it.
+		* 								If false, pages are raw memory and the owner constructs and destroys elements.
+		*/
+		template <typename Element, typename Allocator, bool ConstructElements>
+		class ConcurrentPages
+		{
+		private:
+
+			// allocator types, rebound from the given allocator
+			typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Element> ElementsAllocator;
+			typedef std::allocator_traits<ElementsAllocator> ElementsAllocatorTraits;
+
+			// allocator to use for pages memory
+			ElementsAllocator _allocator;
+
+			// pages table (NULL for pages not allocated yet).
+			std::atomic<Element*> _pages[ConcurrentPagesCount];
+
+		public:
+
+			/*! \brief	Constructor. */
+			ConcurrentPages(const Allocator& allocator = Allocator()) : _allocator(allocator)
+			{
+				for (size_t i = 0; i < ConcurrentPagesCount; ++i) { _pages[i].store(NULL, std::memory_order_relaxed); }
+			}
+
+			/*! \brief	Destructor - free all pages. */
+			~ConcurrentPages()
+			{
+				for (size_t i = 0; i < ConcurrentPagesCount; ++i)
+				{
+					Element* page = _pages[i].load(std::memory_order_relaxed);
+					if (page) { free_page(page, page_size(i)); }
+				}
+			}
+
+			// pages are raw memory, so they can't be copied
+			ConcurrentPages(const ConcurrentPages&) = delete;
+			ConcurrentPages& operator=(const ConcurrentPages&) = delete;
+
+			/*! \brief	Get the page that holds a given index. */
+			static inline size_t page_of(size_t index) { return highest_set_bit(BitmapWord((index >> ConcurrentFirstPageShift) + 1)); }
+
+			/*! \brief	Get the first index in a given page. */
+			static inline size_t page_begin(size_t page) { return ((size_t(1) << page) - 1) << ConcurrentFirstPageShift; }
+
+			/*! \brief	Get how many elements a given page holds. */
+			static inline size_t page_size(size_t page) { return size_t(1) << (page + ConcurrentFirstPageShift); }
+
+			/*! \brief	Get a page memory, or NULL if not allocated yet. */
+			inline Element* page(size_t page) const { return _pages[page].load(std::memory_order_acquire); }
+
+			/*! \brief	Get element by index. Page must be allocated. */
+			inline Element& operator[](size_t index) { size_t page = page_of(index); return this->page(page)[index - page_begin(page)]; }
+			inline const Element& operator[](size_t index) const { size_t page = page_of(index); return this->page(page)[index - page_begin(page)]; }
+
+			/*! \brief	Get element by index, or NULL if its page is not allocated. */
+			inline Element* try_get(size_t index) const
+			{
+				size_t page = page_of(index);
+				Element* memory = this->page(page);
+				return memory ? memory + (index - page_begin(page)) : NULL;
+			}
+
+			/*!
+			 * \fn	inline void ConcurrentPages::ensure(size_t index)
+			 *
+			 * \brief	Make sure the page that holds a given index is allocated.
+			 * 			If several threads need the same page at once, they all allocate it but only one of them wins
+			 * 			and the rest free their copy.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Element index.
+			 */
+			inline void ensure(size_t index)
+			{
+				size_t page = page_of(index);
+				if (_pages[page].load(std::memory_order_acquire)) { return; }
+
+				// allocate page and try to set it
+				size_t size = page_size(page);
+				Element* memory = ElementsAllocatorTraits::allocate(_allocator, size);
+				construct_elements(memory, size, std::integral_constant<bool, ConstructElements>());
+				Element* expected = NULL;
+				if (!_pages[page].compare_exchange_strong(expected, memory, std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					free_page(memory, size);
+				}
+			}
+
+		private:
+
+			// value-initialize a new page elements (or leave raw memory for the owner).
+			inline void construct_elements(Element* memory, size_t size, std::true_type)
+			{
+				for (size_t i = 0; i < size; ++i) { ElementsAllocatorTraits::construct(_allocator, memory + i); }
+			}
+			inline void construct_elements(Element*, size_t, std::false_type) { }
+
+			// destroy a page elements (if we constructed them).
+			inline void destroy_elements(Element* memory, size_t size, std::true_type)
+			{
+				for (size_t i = 0; i < size; ++i) { ElementsAllocatorTraits::destroy(_allocator, memory + i); }
+			}
+			inline void destroy_elements(Element*, size_t, std::false_type) { }
+
+			// destroy elements (if we constructed them) and free page memory.
+			inline void free_page(Element* memory, size_t size)
+			{
+				destroy_elements(memory, size, std::integral_constant<bool, ConstructElements>());
+				ElementsAllocatorTraits::deallocate(_allocator, memory, size);
+			}
+		};
+	}
+}
@@ -0,0 +1,750 @@
+/*!
+* \file	include\dcm_pool\concurrent_pool.h.
+*
+* \brief		Define the ConcurrentDcmPool template class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "concurrent_pages.h"
+#include "concurrent_free_stack.h"
+#include "concurrent_slots_table.h"
+#include "exceptions.h"
+#include "defs.h"
+
+using namespace std;
+
+namespace dcm_pool
+{
+	/*!
+	 * \class	ConcurrentDcmPool
+	 *
+	 * \brief	A thread-safe variant of DcmPool: objects can be allocated, released and accessed from multiple threads
+	 * 			at once, without locks.
+	 *
+	 * 			Differences from DcmPool:
+	 * 				- Objects are stored in pages that are never moved when the pool grows (page N holds 64 << N objects),
+	 * 				  so growing the pool doesn't invalidate objects other threads are using.
+	 * 				- New objects fill holes via a lock-free stack of free indices, or take a new index at the end of the pool
+	 * 				  by atomically increasing its size.
+	 * 				- Ids are converted to objects via a slots table that multiple threads can use at once.
+	 * 				- The pool never defrags by itself. Call Defrag() when no other thread uses the pool (for example once
+	 * 				  per frame after all workers are done), and iterate it only at such points as well.
+	 *
+	 * 			Thread safety:
+	 * 				- Alloc(), Emplace(), Release(), TryRelease(), IsAlive(), TryGet() and accessing objects via Ptr can be
+	 * 				  called from any thread at any time.
+	 * 				- ForEach(), Defrag(), Clear() and Reserve() may only be called when no other thread uses the pool.
+	 * 				- Don't release an object while another thread is still using it.
+	 *
+	 * 			When many threads allocate a lot of objects at once, use a ThreadCache per thread to avoid contention.
+	 *
+	 * \author	Ronen
+	 * \date	10/16/2026
+	 *
+	 * \tparam	T			Type of objects to place in pool.
+	 * \tparam	Allocator	Allocator to use for all the pool's memory (objects, ids and slots table). Defaults to std::allocator<T>.
+	 */
+	template <typename T, typename Allocator = std::allocator<T> >
+	class ConcurrentDcmPool
+	{
+	public:
+
+		/*!
+		 * \class	Ptr
+		 *
+		 * \brief	A pointer to an object inside this pool.
+		 * 			Caches the object address, so accessing the object is direct as long as the pool wasn't defragged.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		class Ptr
+		{
+		private:
+
+			/*! \brief	The pool containing this object. */
+			ConcurrentDcmPool<T, Allocator>* _pool;
+
+			/*! \brief	The object's unique id. */
+			ObjectId _id;
+
+			/*! \brief	Saving a cache of the actual object pointer. */
+			T* _cached_ptr;
+
+			/*! \brief	Last pool version to indicate if cached pointer is still valid to use. */
+			unsigned int _pool_defrag_version;
+
+		public:
+
+			/*!
+			 * \fn	Ptr::Ptr(ConcurrentDcmPool<T, Allocator>* pool = NULL, ObjectId id = ObjectPoolMaxIndex)
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	pool	The parent objects pool.
+			 * \param	id		Object's unique id in pool.
+			 */
+			Ptr(ConcurrentDcmPool<T, Allocator>* pool = NULL, ObjectId id = ObjectPoolMaxIndex) :
+				_pool(pool), _id(id), _cached_ptr(NULL), _pool_defrag_version((unsigned int)-1) {}
+
+			/*!
+			 * \fn	inline ObjectId Ptr::_get_id() const
+			 *
+			 * \brief	Gets the object id in pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Return the object id.
+			 */
+			inline ObjectId _get_id() const { return _id; }
+
+			/*!
+			 * \fn	inline bool Ptr::IsAlive() const
+			 *
+			 * \brief	Check if the object this pointer points on is still alive in pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	True if object is alive, false if released or pointer is empty.
+			 */
+			inline bool IsAlive() const { return _pool && _pool->IsAlive(_id); }
+
+			/*!
+			 * \fn	T& Ptr::operator*(void)
+			 *
+			 * \brief	Return the object itself.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	The object instance.
+			 */
+			inline T& operator*(void)
+			{
+				if (_pool_defrag_version != _pool->_get_defrags_count())
+				{
+					_cached_ptr = &_pool->_get_object(_id);
+					_pool_defrag_version = _pool->_get_defrags_count();
+				}
+				return *_cached_ptr;
+			}
+
+			/*!
+			 * \fn	T* Ptr::operator->(void)
+			 *
+			 * \brief	Member dereference operator.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	The dereferenced object.
+			 */
+			inline T* operator->(void) { return &(this->operator*()); }
+
+			/*!
+			 * \fn	inline bool Ptr::operator==(const Ptr& other) const
+			 *
+			 * \brief	Equality operator.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	other	The other pointer to compare to.
+			 *
+			 * \return	True if the parameters are considered equivalent.
+			 */
+			inline bool operator==(const Ptr& other) const { return _id == other._id && _pool == other._pool; }
+
+			/*!
+			 * \fn	inline bool Ptr::operator!=(const Ptr& other) const
+			 *
+			 * \brief	Inequality operator.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	other	The other pointer to compare to.
+			 *
+			 * \return	True if the parameters are not considered equivalent.
+			 */
+			inline bool operator!=(const Ptr& other) const { return !(*this == other); }
+		};
+
+		/*!
+		 * \class	ThreadCache
+		 *
+		 * \brief	A front-end to the pool owned by a single thread, so the thread can allocate and release objects without
+		 * 			touching any shared state most of the time.
+		 * 			The cache takes indices and slots from the pool in bulk: all the pool's holes at once, or a range of new
+		 * 			indices at the end of the pool. Objects released via the cache are kept for its own future allocations.
+		 * 			Synchronize() returns everything the cache holds to the pool in bulk (call it at the end of every frame,
+		 * 			before defragging or iterating the pool). All objects live in the same pool, so iteration still walks
+		 * 			one contiguous space.
+		 *
+		 * 			Usage example (every worker thread):
+		 * 				ConcurrentDcmPool<Bullet>::ThreadCache cache(bullets);
+		 * 				auto bullet = cache.Emplace(position, velocity);
+		 * 				...
+		 * 				cache.Synchronize();	// end of frame
+		 *
+		 * 			Notes:
+		 * 				- Only the owner thread may use the cache, but objects can be accessed and released by any thread.
+		 * 				- The pool's size() doesn't count objects allocated and released via caches until they synchronize.
+		 * 				- All caches must synchronize before calling Defrag(), ForEach() or Clear() on the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		class ThreadCache
+		{
+		private:
+
+			/*! \brief	The shared pool. */
+			ConcurrentDcmPool<T, Allocator>* _pool;
+
+			/*! \brief	How many new indices and slots to reserve at once. */
+			size_t _batch;
+
+			/*! \brief	Free indices and slots we own (holes taken from the pool, or objects released via this cache). */
+			_internal::LocalFreeList _free_indices;
+			_internal::LocalFreeList _free_slots;
+
+			/*! \brief	Range of new indices and slots we reserved and didn't use yet. */
+			size_t _next_index;
+			size_t _indices_end;
+			size_t _next_slot;
+			size_t _slots_end;
+
+			/*! \brief	How many objects we allocated minus how many we released since last synchronize. */
+			size_t _objects_count_delta;
+
+		public:
+
+			/*!
+			 * \fn	ThreadCache::ThreadCache(ConcurrentDcmPool<T, Allocator>& pool, size_t batch = DefaultThreadCacheBatch)
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	pool	The shared pool.
+			 * \param	batch	How many new indices and slots to reserve at once.
+			 */
+			ThreadCache(ConcurrentDcmPool<T, Allocator>& pool, size_t batch = DefaultThreadCacheBatch) :
+				_pool(&pool), _batch(batch ? batch : 1), _next_index(0), _indices_end(0), _next_slot(0), _slots_end(0), _objects_count_delta(0) {}
+
+			/*!
+			 * \fn	ThreadCache::~ThreadCache()
+			 *
+			 * \brief	Destructor - returns everything to the pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			~ThreadCache() { Synchronize(); }
+
+			// cache owns part of the pool, so it can't be copied
+			ThreadCache(const ThreadCache&) = delete;
+			ThreadCache& operator=(const ThreadCache&) = delete;
+
+			/*!
+			 * \fn	Ptr ThreadCache::Alloc()
+			 *
+			 * \brief	Allocate a default-constructed object from the pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	A pointer to the newly allocated object.
+			 */
+			inline Ptr Alloc() { return Emplace(); }
+
+			/*!
+			 * \fn	template <typename... Args> Ptr ThreadCache::Emplace(Args&&... args);
+			 *
+			 * \brief	Allocate an object from the pool, constructing it with the given arguments.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	args	Arguments to pass to the object's constructor.
+			 *
+			 * \return	A pointer to the newly allocated object.
+			 */
+			template <typename... Args>
+			Ptr Emplace(Args&&... args);
+
+			/*!
+			 * \fn	void ThreadCache::Release(const Ptr& obj)
+			 *
+			 * \brief	Releases the given object (may be allocated by any thread).
+			 * 			Will throw AccessViolation if object was already released.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	obj	The object to release.
+			 */
+			inline void Release(const Ptr& obj) { Release(obj._get_id()); }
+
+			/*!
+			 * \fn	void ThreadCache::Release(ObjectId id)
+			 *
+			 * \brief	Releases an object by id (may be allocated by any thread).
+			 * 			Will throw AccessViolation if object was already released.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	The object id to release.
+			 */
+			inline void Release(ObjectId id) { if (!TryRelease(id)) { throw AccessViolation(); } }
+
+			/*!
+			 * \fn	bool ThreadCache::TryRelease(ObjectId id);
+			 *
+			 * \brief	Releases an object by id if its still alive.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	The object id to release.
+			 *
+			 * \return	True if object was released, false if it was already released.
+			 */
+			bool TryRelease(ObjectId id);
+
+			/*!
+			 * \fn	void ThreadCache::Synchronize();
+			 *
+			 * \brief	Return all the indices and slots the cache holds to the pool, and update the pool's objects count.
+			 * 			Each list is returned with a single update of the shared pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			void Synchronize();
+
+		private:
+
+			/*!
+			 * \fn	size_t ThreadCache::AllocIndex();
+			 *
+			 * \brief	Take an index for a new object, from our free indices, our reserved range, or the pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Index to use.
+			 */
+			inline size_t AllocIndex();
+
+			/*!
+			 * \fn	size_t ThreadCache::AllocSlot();
+			 *
+			 * \brief	Take a slot for a new object, from our free slots, our reserved range, or the pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Slot to use.
+			 */
+			inline size_t AllocSlot();
+		};
+
+	private:
+
+		/*!
+		* \struct	Entry
+		*
+		* \brief	Per-index data, stored next to the objects.
+		*/
+		struct Entry
+		{
+			// id of the object in this index. for free indices this is the next free index.
+			std::atomic<ObjectId> id;
+
+			// is this index currently used.
+			std::atomic<bool> used;
+
+			Entry() : id(0), used(false) { }
+		};
+
+		/*! \brief	The pooled objects (raw memory, constructed on alloc). */
+		_internal::ConcurrentPages<T, Allocator, false> _objects;
+
+		/*! \brief	Id and used flag for every index in objects. */
+		_internal::ConcurrentPages<Entry, Allocator, true> _entries;
+
+		/*! \brief	Convert unique object id to its index in objects. */
+		_internal::ConcurrentSlotsTable<Allocator> _slots;
+
+		/*! \brief	Free indices inside the pool (holes), to fill before taking new indices. */
+		_internal::ConcurrentFreeStack _holes;
+
+		/*! \brief	Max objects count in pool. */
+		size_t _max_size;
+
+		/*! \brief	How many times was this pool defragged? */
+		unsigned int _defrags_count;
+
+		/*! \brief	How many indices we used since last defrag (new objects that don't fill holes take the next index). */
+		alignas(_internal::ConcurrentCacheLineSize) std::atomic<size_t> _used_size;
+
+		/*! \brief	Current pool actual size (allocated objects). */
+		alignas(_internal::ConcurrentCacheLineSize) std::atomic<size_t> _allocated_objects_count;
+
+	public:
+
+		/*!
+		 * \fn	ConcurrentDcmPool::ConcurrentDcmPool(size_t max_size = 0, size_t reserve = 0, const Allocator& allocator = Allocator());
+		 *
+		 * \brief	Constructor
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_size	Maximum objects count in pool. Set to 0 for unlimited count.
+		 * \param	reserve		How many objects to allocate memory for in advance.
+		 * \param	allocator	Allocator instance to use for all the pool's memory.
+		 */
+		ConcurrentDcmPool(size_t max_size = 0, size_t reserve = 0, const Allocator& allocator = Allocator());
+
+		/*!
+		 * \fn	ConcurrentDcmPool::~ConcurrentDcmPool();
+		 *
+		 * \brief	Destructor - destroy all objects in pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		~ConcurrentDcmPool();
+
+		// pool owns its objects memory, so it can't be copied
+		ConcurrentDcmPool(const ConcurrentDcmPool&) = delete;
+		ConcurrentDcmPool& operator=(const ConcurrentDcmPool&) = delete;
+
+		/*!
+		 * \fn	Ptr ConcurrentDcmPool::Alloc();
+		 *
+		 * \brief	Allocate a default-constructed object from the pool (thread safe).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	A pointer to the newly allocated object.
+		 */
+		inline Ptr Alloc() { return Emplace(); }
+
+		/*!
+		 * \fn	template <typename... Args> Ptr ConcurrentDcmPool::Emplace(Args&&... args);
+		 *
+		 * \brief	Allocate an object from the pool, constructing it with the given arguments (thread safe).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	args	Arguments to pass to the object's constructor.
+		 *
+		 * \return	A pointer to the newly allocated object.
+		 */
+		template <typename... Args>
+		Ptr Emplace(Args&&... args);
+
+		/*!
+		 * \fn	void ConcurrentDcmPool::Release(const Ptr& obj);
+		 *
+		 * \brief	Releases the given object (thread safe).
+		 * 			Will throw AccessViolation if object was already released.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	obj	The object to release.
+		 */
+		inline void Release(const Ptr& obj) { Release(obj._get_id()); }
+
+		/*!
+		 * \fn	void ConcurrentDcmPool::Release(ObjectId id);
+		 *
+		 * \brief	Releases an object by id (thread safe).
+		 * 			Will throw AccessViolation if object was already released.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id to release.
+		 */
+		void Release(ObjectId id);
+
+		/*!
+		 * \fn	bool ConcurrentDcmPool::TryRelease(ObjectId id);
+		 *
+		 * \brief	Releases an object by id if its still alive (thread safe).
+		 * 			If several threads release the same object at once, only one of them will succeed.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id to release.
+		 *
+		 * \return	True if object was released, false if it was already released.
+		 */
+		bool TryRelease(ObjectId id);
+
+		/*!
+		 * \fn	inline bool ConcurrentDcmPool::IsAlive(ObjectId id) const
+		 *
+		 * \brief	Check if an object id belongs to a live object in this pool (thread safe).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id to check.
+		 *
+		 * \return	True if object is alive.
+		 */
+		inline bool IsAlive(ObjectId id) const { return _slots.is_alive(id); }
+
+		/*!
+		 * \fn	T* ConcurrentDcmPool::TryGet(ObjectId id);
+		 *
+		 * \brief	Get an object by id, or NULL if the object was released (thread safe).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id to get.
+		 *
+		 * \return	Pointer to the object, or NULL if not alive.
+		 */
+		inline T* TryGet(ObjectId id) { return _slots.is_alive(id) ? &_objects[_slots.get_index(id)] : NULL; }
+
+		/*!
+		 * \fn	const T* ConcurrentDcmPool::TryGet(ObjectId id) const;
+		 *
+		 * \brief	Get an object by id, or NULL if the object was released (thread safe).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id to get.
+		 *
+		 * \return	Pointer to the object, or NULL if not alive.
+		 */
+		inline const T* TryGet(ObjectId id) const { return _slots.is_alive(id) ? &_objects[_slots.get_index(id)] : NULL; }
+
+		/*!
+		 * \fn	inline size_t ConcurrentDcmPool::size() const
+		 *
+		 * \brief	Gets the pool current size (allocated objects).
+		 * 			While other threads allocate and release objects this is only a snapshot.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Objects count.
+		 */
+		inline size_t size() const { return _allocated_objects_count.load(std::memory_order_relaxed); }
+
+		/*!
+		 * \fn	inline size_t ConcurrentDcmPool::HolesCount() const
+		 *
+		 * \brief	Gets how many holes the pool has (released objects that Defrag() will close).
+		 * 			While other threads allocate and release objects this is only a snapshot.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Holes count.
+		 */
+		inline size_t HolesCount() const { return _used_size.load(std::memory_order_relaxed) - _allocated_objects_count.load(std::memory_order_relaxed); }
+
+		/*!
+		 * \fn	void ConcurrentDcmPool::Reserve(size_t amount);
+		 *
+		 * \brief	Allocate memory for a given amount of objects in advance. Only when no other thread uses the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	amount	How many objects to allocate memory for.
+		 */
+		void Reserve(size_t amount);
+
+		/*!
+		 * \fn	template <typename Callback> void ConcurrentDcmPool::ForEach(Callback&& callback);
+		 *
+		 * \brief	Run a callback on all objects in pool. Only when no other thread uses the pool.
+		 * 			Accepts the same callbacks as DcmPool::ForEach(), with the pool as ConcurrentDcmPool.
+		 * 			Doesn't defrag, holes are skipped.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	Callable that accepts (T&), (T&, ObjectId) or (T&, ObjectId, ConcurrentDcmPool&).
+		 */
+		template <typename Callback>
+		void ForEach(Callback&& callback);
+
+		/*!
+		 * \fn	template <typename Callback> void ConcurrentDcmPool::ForEach(Callback&& callback) const;
+		 *
+		 * \brief	Run a callback on all objects in pool (const version). Only when no other thread uses the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	Callable that accepts (const T&), (const T&, ObjectId) or (const T&, ObjectId, const ConcurrentDcmPool&).
+		 */
+		template <typename Callback>
+		void ForEach(Callback&& callback) const;
+
+		/*!
+		* \fn	void ConcurrentDcmPool::Defrag();
+		*
+		* \brief	Close all holes in pool, so objects are contiguous again. Only when no other thread uses the pool.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*/
+		void Defrag();
+
+		/*!
+		 * \fn	void ConcurrentDcmPool::Clear();
+		 *
+		 * \brief	Release all objects in pool. Only when no other thread uses the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void Clear();
+
+		/*!
+		 * \fn	T& ConcurrentDcmPool::_get_object(ObjectId id);
+		 *
+		 * \brief	Get object by id (internal). Will throw AccessViolation if object is not alive.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	The object id.
+		 *
+		 * \return	The object.
+		 */
+		T& _get_object(ObjectId id);
+
+		/*!
+		 * \fn	inline unsigned int ConcurrentDcmPool::_get_defrags_count() const
+		 *
+		 * \brief	Gets how many times the pool was defragged (used by Ptr to know when to refresh cached address).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Defrags count.
+		 */
+		inline unsigned int _get_defrags_count() const { return _defrags_count; }
+
+		/*! \brief	Get the link to next free index, for the holes stack (internal). */
+		inline std::atomic<size_t>& free_link(size_t index) { return _entries[index].id; }
+
+	private:
+
+		/*!
+		 * \fn	size_t ConcurrentDcmPool<T>::AllocIndex();
+		 *
+		 * \brief	Take an index for a new object: a hole if there is one, or the next new index (thread safe).
+		 * 			Will throw ExceededPoolLimit if the pool is full.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Index to use.
+		 */
+		inline size_t AllocIndex();
+
+		/*!
+		 * \fn	size_t ConcurrentDcmPool<T>::ReserveIndices(size_t count, size_t& first);
+		 *
+		 * \brief	Reserve a range of new indices at the end of the pool, with a single update (thread safe).
+		 * 			Will throw ExceededPoolLimit if the pool is full.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	count	How many indices to reserve.
+		 * \param	first	Will be set to the first reserved index.
+		 *
+		 * \return	How many indices were reserved (may be less than count near max size, but never 0).
+		 */
+		inline size_t ReserveIndices(size_t count, size_t& first);
+
+		/*!
+		 * \fn	template <typename... Args> void ConcurrentDcmPool<T>::ConstructObject(size_t index, ObjectId id, Args&&... args);
+		 *
+		 * \brief	Construct a new object in an index we own and set its id (the id is not published yet).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		template <typename... Args>
+		inline void ConstructObject(size_t index, ObjectId id, Args&&... args);
+
+		/*!
+		 * \fn	void ConcurrentDcmPool<T>::DestroyObject(size_t index);
+		 *
+		 * \brief	Destroy a released object and mark its index as unused.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void DestroyObject(size_t index);
+
+		/*!
+		 * \fn	void ConcurrentDcmPool<T>::MoveObject(size_t from, size_t to, std::false_type relocatable);
+		 *
+		 * \brief	Move an object to an unused index using its move constructor (while defragging).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void MoveObject(size_t from, size_t to, std::false_type relocatable);
+
+		/*!
+		 * \fn	void ConcurrentDcmPool<T>::MoveObject(size_t from, size_t to, std::true_type relocatable);
+		 *
+		 * \brief	Move a trivially relocatable object to an unused index with memcpy (while defragging).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void MoveObject(size_t from, size_t to, std::true_type relocatable);
+
+		/*!
+		 * \fn	template <typename Self, typename Callback> static void ConcurrentDcmPool<T>::ForEachUsed(Self& self, Callback& callback);
+		 *
+		 * \brief	Run callback on all used objects, page by page (shared by const and non-const ForEach).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		template <typename Self, typename Callback>
+		static inline void ForEachUsed(Self& self, Callback& callback);
+	};
+}
+
+#include "_concurrent_pool_imp.h"
@@ -0,0 +1,287 @@
+/*!
+* \file	include\dcm_pool\concurrent_slots_table.h.
+*
+* \brief		An internal table to convert object ids to their index in pool, that multiple threads can use at once.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "concurrent_pages.h"
+#include "concurrent_free_stack.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	ConcurrentSlotsTable
+		*
+		* \brief	Like SlotsTable, but slots can be allocated, released and checked from multiple threads at once.
+		* 			New slots are reserved by atomically increasing the table size, and released slots are reused via a
+		* 			lock-free free-slots stack (linked through the free slots' index, like SlotsTable).
+		* 			Releasing a slot moves its generation from used to free with a compare-and-swap, so when several
+		* 			threads release the same id only one of them succeeds.
+		*
+		* 			Changing slots index (set_index()) and clear() are only allowed when no other thread uses the table.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Allocator	Allocator to use for the slots memory (rebound to the slot type).
+		*/
+		template <typename Allocator = std::allocator<ObjectId> >
+		class ConcurrentSlotsTable
+		{
+		private:
+
+			/*!
+			* \struct	Slot
+			*
+			* \brief	A single slot in table.
+			*/
+			struct Slot
+			{
+				// for used slots this is object index in pool, for free slots this is the next free slot.
+				std::atomic<size_t> index;
+
+				// slot generation (odd = used, even = free).
+				std::atomic<size_t> generation;
+
+				Slot() : index(0), generation(0) { }
+			};
+
+			// the slots.
+			ConcurrentPages<Slot, Allocator, true> _slots;
+
+			// free slots to reuse.
+			ConcurrentFreeStack _free;
+
+			// how many slots we ever used (new slots are taken from here).
+			alignas(ConcurrentCacheLineSize) std::atomic<size_t> _size;
+
+		public:
+
+			/*!
+			 * \fn	ConcurrentSlotsTable::ConcurrentSlotsTable(const Allocator& allocator = Allocator())
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	allocator	Allocator to use for the slots memory.
+			 */
+			ConcurrentSlotsTable(const Allocator& allocator = Allocator()) : _slots(allocator), _size(0) { }
+
+			/*!
+			 * \fn	ObjectId ConcurrentSlotsTable::alloc(size_t index);
+			 *
+			 * \brief	Allocate a slot for a new object (thread safe).
+			 * 			The new id is not alive until publish() is called, so the caller can finish setting up the object
+			 * 			before other threads can see or release it.
+			 * 			Will throw ExceededPoolLimit if there are no more slots to use.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Index of the new object in pool.
+			 *
+			 * \return	The new object id.
+			 */
+			inline ObjectId alloc(size_t index);
+
+			/*!
+			 * \fn	inline void ConcurrentSlotsTable::publish(ObjectId id)
+			 *
+			 * \brief	Make an id returned by alloc() alive (thread safe).
+			 * 			Everything the calling thread wrote before is visible to threads that see the id alive.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to publish.
+			 */
+			inline void publish(ObjectId id) { _slots[get_id_slot(id)].generation.store(get_id_generation(id), std::memory_order_release); }
+
+			/*!
+			 * \fn	inline ObjectId ConcurrentSlotsTable::assign(size_t slot, size_t index)
+			 *
+			 * \brief	Like alloc(), but for a slot the caller already owns (taken via reserve() or take_free()).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	slot	Slot to use.
+			 * \param	index	Index of the new object in pool.
+			 *
+			 * \return	The new object id.
+			 */
+			inline ObjectId assign(size_t slot, size_t index);
+
+			/*!
+			 * \fn	inline void ConcurrentSlotsTable::cancel(ObjectId id)
+			 *
+			 * \brief	Return an id from alloc() that was never published to the free slots (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to cancel.
+			 */
+			inline void cancel(ObjectId id) { _free.push(get_id_slot(id), *this); }
+
+			/*!
+			 * \fn	size_t ConcurrentSlotsTable::reserve(size_t count, size_t& first);
+			 *
+			 * \brief	Reserve a range of new slots for the caller's own use, with a single update (thread safe).
+			 * 			Will throw ExceededPoolLimit if there are no more slots to use.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	count	How many slots to reserve.
+			 * \param	first	Will be set to the first reserved slot.
+			 *
+			 * \return	How many slots were reserved (may be less than count near the limit, but never 0).
+			 */
+			inline size_t reserve(size_t count, size_t& first);
+
+			/*!
+			 * \fn	inline size_t ConcurrentSlotsTable::take_free()
+			 *
+			 * \brief	Take all the free slots at once (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	First slot of the free slots chain, or ObjectPoolMaxIndex if there are none.
+			 */
+			inline size_t take_free() { return _free.take_all(); }
+
+			/*!
+			 * \fn	inline void ConcurrentSlotsTable::return_free(LocalFreeList& slots)
+			 *
+			 * \brief	Return a list of free slots owned by the caller, with a single update (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	slots	Free slots to return (will be emptied).
+			 */
+			inline void return_free(LocalFreeList& slots) { slots.flush(_free, *this); }
+
+			/*!
+			 * \fn	bool ConcurrentSlotsTable::retire(ObjectId id, size_t& index);
+			 *
+			 * \brief	Like release(), but doesn't add the slot to the free slots, so the caller owns it (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id		Object id to release.
+			 * \param	index	Will be set to the released object index in pool.
+			 *
+			 * \return	True if released, false if id was not alive (or another thread released it first).
+			 */
+			inline bool retire(ObjectId id, size_t& index);
+
+			/*!
+			 * \fn	bool ConcurrentSlotsTable::release(ObjectId id, size_t& index);
+			 *
+			 * \brief	Release a slot so it can be reused by future objects (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id		Object id to release.
+			 * \param	index	Will be set to the released object index in pool.
+			 *
+			 * \return	True if released, false if id was not alive (or another thread released it first).
+			 */
+			inline bool release(ObjectId id, size_t& index);
+
+			/*!
+			 * \fn	inline bool ConcurrentSlotsTable::is_alive(ObjectId id) const
+			 *
+			 * \brief	Check if an id belongs to a currently used slot (thread safe).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to check.
+			 *
+			 * \return	True if id is used and not stale.
+			 */
+			inline bool is_alive(ObjectId id) const
+			{
+				const Slot* slot = get_slot(id);
+				size_t generation = get_id_generation(id);
+				return slot && (generation & 1) && slot->generation.load(std::memory_order_acquire) == generation;
+			}
+
+			/*!
+			 * \fn	inline size_t ConcurrentSlotsTable::get_index(ObjectId id) const
+			 *
+			 * \brief	Gets the index in pool of a given object id.
+			 * 			Note: does not validate id, use is_alive() first if not sure.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to get index for.
+			 *
+			 * \return	Object index in pool.
+			 */
+			inline size_t get_index(ObjectId id) const { return _slots[get_id_slot(id)].index.load(std::memory_order_relaxed); }
+
+			/*!
+			 * \fn	inline void ConcurrentSlotsTable::set_index(ObjectId id, size_t index)
+			 *
+			 * \brief	Update the index in pool of a given object id (used when objects move during defrag).
+			 * 			Only when no other thread uses the table.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id		Object id to update.
+			 * \param	index	New object index in pool.
+			 */
+			inline void set_index(ObjectId id, size_t index) { _slots[get_id_slot(id)].index.store(index, std::memory_order_relaxed); }
+
+			/*!
+			 * \fn	void ConcurrentSlotsTable::clear();
+			 *
+			 * \brief	Clears the table and release all slots. Only when no other thread uses the table.
+			 * 			Note: keeps slots memory and generations, so ids from before clearing will not become valid again.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			inline void clear();
+
+			/*! \brief	Get the link to next free slot, for the free slots stack (internal). */
+			inline std::atomic<size_t>& free_link(size_t slot) { return _slots[slot].index; }
+
+		private:
+
+			// get the slot of an id, or NULL if id is out of range.
+			inline const Slot* get_slot(ObjectId id) const
+			{
+				size_t slot = get_id_slot(id);
+				return slot < _size.load(std::memory_order_acquire) ? _slots.try_get(slot) : NULL;
+			}
+		};
+	}
+}
+
+#include "_concurrent_slots_table_imp.h"
@@ -11,10 +11,23 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
+#include <chrono>
 #include "object_ptr.h"
+#include "object_handle.h"
+#include "objects_storage.h"
 #include "holes_list.h"
+#include "occupancy_bitmap.h"
+#include "iterators.h"
+#include "thread_pool.h"
+#include "slots_table.h"
+#include "release_queue.h"
 #include "defs.h"
+#if DCM_POOL_CPP_VERSION >= 201703L
+#include <memory_resource>
+#endif
+#if DCM_POOL_CPP_VERSION >= 202002L
+#include <span>
+#endif
 
 using namespace std;
 
@@ -34,22 +47,25 @@ namespace dcm_pool
 	 *
 	 * 			Notes:
 	 * 				- To access an object from the pool externally (eg not via iteration) you need to use the DcmPool<T>::Ptr object.
-	 * 				- The pool use the move assignment operator internally, so implementing it will boost performance greatly.
-	 * 				- Your objects (T) must have a default constructor, and obviously an Init() function you'll need to call manually after allocating.
-	 * 				- The pool is not thread safe!
+	 * 				- The pool use the move constructor internally, so implementing it will boost performance greatly.
+	 * 				- Objects are constructed when allocated (Alloc() / Emplace()) and destroyed when released. Unused objects are not constructed.
+	 * 				- The pool is not thread safe! (use ConcurrentDcmPool to allocate and release from multiple threads)
 	 *
 	 * 			Performance:
 	 * 				- Iterating objects in the pool is optimal, eg O(N) on a contiguous memory block.
-	 * 				- Allocting is normally O(1) (unless exceed memory block and need to realloc the whole pool - can be avoided with reserved).
+	 * 				- Allocting is normally O(1) (unless exceed memory block and need to realloc the whole pool - can be avoided with reserved,
+	 * 				  or by using STORAGE_PAGED / STORAGE_VIRTUAL modes which never move objects when growing).
 	 * 				- Releasing is normally O(1).
-	 * 				- Accessing from the object pointer is ~O(1), sometimes will invoke accessing unordered map.
+	 * 				- Accessing from the object pointer is O(1), sometimes will invoke accessing the slots table.
 	 *
 	 * 			Defragging:
 	 * 				To keep the memory Contiguous, there's a need to 'close holes' whenever they are created, eg when an object is 
-	 * 				released from the pool (and its index is not the last index). There are 3 modes to handle defragging:
+	 * 				released from the pool (and its index is not the last index). There are 5 modes to handle defragging:
 	 * 				- DEFRAG_IMMEDIATE: will close holes the moment they are created. This option is not optimal but have predictable speed.  
 	 * 				- DEFRAG_DEFERRED: will do defragging when trying to iterate the pool. More efficient, but less predictable.
 	 *				- DEFRAG_MANUAL: will not do defragging automatically, you need to call Defrag() yourself when you see fit.
+	 *				- DEFRAG_STABLE: like deferred, but keeps objects in allocation order (new objects never fill holes).
+	 *				- DEFRAG_INCREMENTAL: like deferred, but every iteration only closes a limited number of holes.
 	 *
 	 * 			Usecase:
 	 * 				This pool is useful for scenarios where you need to do a lot of allocating and releasing of objects, while
@@ -68,20 +84,26 @@ namespace dcm_pool
 	 *				3. c. Defragging takes O(N), where N is number of holes (not number of pool). We close holes by taking objects from the end of the vector.
 	 *			4. To iterate the vector you call Iterate(), which takes a function pointer to run on every valid object in pool.
 	 *			5. Since defragging shuffles memory, you can't access objects by index. To solve this, we use a special pointer class to allow access to specific objects:
-	 *				5. a. Every object in pool is asigned with a unique id.
-	 *				5. b. The pool keeps an internal hash table to convert id to actual index (hidden from the user).
-	 *				5. c. When the pointer tries to fetch the object it points on, if the pool was defragged since last access it use the hash table to find the new objects index.
-	 *			6. To store the list of holes in the vector we reuse the free objects, so no additional memory is wasted.
+	 *				5. a. Every object in pool is asigned with a unique id, which is an index of a slot in the pool's slots table.
+	 *				5. b. The pool keeps an internal slots table to convert id to actual index (hidden from the user).
+	 *				5. c. When the pointer tries to fetch the object it points on, if the pool was defragged since last access it use the slots table to find the new objects index.
+	 *			6. To store the list of holes in the vector we reuse the free objects ids, so no additional memory is wasted.
+	 *			7. Objects ids and used flags are kept in separate vectors parallel to the objects vector, so iterating and defragging
+	 *			   only touch the objects memory itself (and small metadata), and the objects vector is a pure T[] array.
 	 *
 	 *
 	 * \author	Ronen
 	 * \date	2/21/2018
 	 *
-	 * \tparam	T	Type of objects to place in pool.
-	 * 				Note: to fully enjoy the benefit of continuous memory and cpu caching, its recommended to
-	 * 				provide an actual type and not a pointer.
+	 * \tparam	T			Type of objects to place in pool.
+	 * 						Note: to fully enjoy the benefit of continuous memory and cpu caching, its recommended to
+	 * 						provide an actual type and not a pointer.
+	 * \tparam	Allocator	Allocator to use for all the pool's memory (objects, ids and slots table). Defaults to std::allocator<T>.
+	 * \tparam	IdTraits	Width and layout of the ids and indices the pool stores per object (see IdTraits). Defaults to
+	 * 						ObjectId wide ids. Use CompactIdTraits for 32-bit ids, to halve the memory of ids, slots and handles,
+	 * 						for pools of up to 16M objects.
 	 */
-	template <typename T>
+	template <typename T, typename Allocator, typename IdTraits>
 	class DcmPool
 	{
 	public:
@@ -94,32 +116,45 @@ namespace dcm_pool
 		 * \author	Ronen
 		 * \date	2/23/2018
 		 */
-		class Ptr : public ObjectPtr<T>
+		class Ptr : public ObjectPtr<T, Allocator, IdTraits>
 		{
 		public:
-			Ptr(DcmPool<T>* pool = NULL, ObjectId id = ObjectPoolMaxIndex) :
-				ObjectPtr<T>(pool, id) {}
+			Ptr(DcmPool<T, Allocator, IdTraits>* pool = NULL, ObjectId id = ObjectPoolMaxIndex) :
+				ObjectPtr<T, Allocator, IdTraits>(pool, id) {}
 		};
 
+		/*! \brief	A compact handle to an object inside this pool (see ObjectHandle). */
+		typedef ObjectHandle<T, Allocator, IdTraits> Handle;
+
 		/*! \brief	Callback to invoke on every new object you allocate. */
-		EventsHandler<T> OnAlloc = NULL;
+		EventsHandler<T, Allocator, IdTraits> OnAlloc = NULL;
 
 		/*! \brief	Callback to invoke on every object you release. */
-		EventsHandler<T> OnRelease = NULL;
+		EventsHandler<T, Allocator, IdTraits> OnRelease = NULL;
 
 	private:
 
+		/*! \brief	Allocators for the pool's internal arrays, rebound from the pool's allocator. */
+		typedef typename IdTraits::Id Id;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Id> IdsAllocator;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<_internal::BitmapWord> FlagsAllocator;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<size_t> IndicesAllocator;
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<unsigned int> VersionsAllocator;
+
 		/*! \brief	The pooled objects. */
-		vector<_internal::ObjectInPool<T> > _objects;
+		_internal::ObjectsStorage<T, Allocator> _objects;
+
+		/*! \brief	Object id for every index in objects vector (for holes this is used to store the holes list). */
+		vector<Id, IdsAllocator> _ids;
+
+		/*! \brief	Is the object in every index in objects vector currently used (bitmap, so iteration can skip holes a word at a time). */
+		_internal::OccupancyBitmap<FlagsAllocator> _is_used;
 
 		/*! \brief	Convert unique object id to its index in pools vector. */
-		unordered_map <ObjectId, size_t> _pointers;
+		_internal::SlotsTable<IdsAllocator, IdTraits> _slots;
 
 		// holes inside the pool
-		_internal::HolesList<T> _holes;
-
-		/*! \brief	Used to assign unique object ids to new objects in pool. */
-		ObjectId _next_object_id;
+		_internal::HolesList<vector<Id, IdsAllocator> > _holes;
 
 		/*! \brief	Max objects count in pool. */
 		size_t _max_size;
@@ -139,8 +174,50 @@ namespace dcm_pool
 		/*! \brief	How many times was this pool defragged? */
 		unsigned int _defrags_count;
 
+		/*! \brief	Defrag version when all objects last moved (storage grew, shrank or was cleared), so all pointers cached before it are invalid. */
+		unsigned int _storage_moved_at;
+
+		/*! \brief	For every page of RelocationPageSize indices, pointers cached before this defrag version are invalid (objects in page were moved or released). */
+		vector<unsigned int, VersionsAllocator> _pages_changed_at;
+
+		/*! \brief	How many times were objects released (pointers that cached their object before a release check if their page changed). */
+		size_t _releases_count;
+
+		/*! \brief	Capacity requested with reserve, we never shrink memory below it. */
+		size_t _reserved_capacity;
+
+		/*! \brief	Total bytes returned to the system by shrinking the pool. */
+		size_t _released_memory_bytes;
+
+		/*! \brief	In DEFRAG_STABLE mode, index of the first hole (or ObjectPoolMaxIndex if there are no holes). */
+		size_t _first_hole;
+
+		/*! \brief	In DEFRAG_INCREMENTAL mode, max objects to move on every iteration. */
+		size_t _incremental_defrag_moves;
+
+		/*! \brief	Holes we're closing in bulk (kept to avoid allocating memory on every defrag). */
+		vector<size_t, IndicesAllocator> _holes_to_close;
+
+		/*! \brief	Indices of objects we allocate or release in batch (kept to avoid allocating memory on every batch). */
+		vector<size_t, IndicesAllocator> _batch_indices;
+
+		/*! \brief	Objects other threads asked to release, until ApplyPendingReleases() is called. */
+		ReleaseQueue _release_queue;
+
 	public:
 
+		/*! \brief	Iterators over live objects (skip holes). */
+		typedef _internal::LiveObjectsIterator<T, _internal::ObjectsStorage<T, Allocator>, _internal::OccupancyBitmap<FlagsAllocator> > iterator;
+		typedef _internal::LiveObjectsIterator<const T, const _internal::ObjectsStorage<T, Allocator>, _internal::OccupancyBitmap<FlagsAllocator> > const_iterator;
+
+		/*! \brief	Iterators over live objects that yield (object, id) pairs. */
+		typedef _internal::LiveObjectsWithIdsIterator<T, _internal::ObjectsStorage<T, Allocator>, _internal::OccupancyBitmap<FlagsAllocator>, Id> ids_iterator;
+		typedef _internal::LiveObjectsWithIdsIterator<const T, const _internal::ObjectsStorage<T, Allocator>, _internal::OccupancyBitmap<FlagsAllocator>, Id> const_ids_iterator;
+
+		/*! \brief	Random access iterators over a pool with no holes. */
+		typedef _internal::DenseObjectsIterator<T, _internal::ObjectsStorage<T, Allocator> > dense_iterator;
+		typedef _internal::DenseObjectsIterator<const T, const _internal::ObjectsStorage<T, Allocator> > const_dense_iterator;
+
 		/*!
 		 * \fn	DcmPool::DcmPool(std::size_t max_size);
 		 *
@@ -152,15 +229,33 @@ namespace dcm_pool
 		 * \param	max_size			Maximum objects count in pool. Set to 0 for unlimited count.
 		 * \param	reserve				How many objects to reserve in the pool memory (using vector's reserve).
 		 * \param	shrink_threshold	The pool uses a vector internally to hold objects. When you allocate more objects, the vector grows.
-		 * 								This number decides when to shrink the vector down, if objects are released.
+		 * 								This number decides when to shrink the vector down, if objects are released
+		 * 								(half of it is kept as free capacity after shrinking).
 		 * \param	defrag_mode			How to handle defragging.
+		 * \param	storage_mode		How to store objects in memory (single contiguous block, pages, or reserved virtual memory).
+		 * \param	allocator			Allocator instance to use for all the pool's memory.
 		 */
-		DcmPool(size_t max_size = 0, size_t reserve = 0, size_t shrink_threshold = 1024, DefragModes defrag_mode = DEFRAG_DEFERRED);
+		DcmPool(size_t max_size = 0, size_t reserve = 0, size_t shrink_threshold = 1024, DefragModes defrag_mode = DEFRAG_DEFERRED, StorageModes storage_mode = STORAGE_CONTIGUOUS, const Allocator& allocator = Allocator());
+
+		/*!
+		 * \fn	DcmPool::~DcmPool();
+		 *
+		 * \brief	Destructor - destroy all objects in pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		~DcmPool();
+
+		// pool owns its objects memory, so it can't be copied
+		DcmPool(const DcmPool&) = delete;
+		DcmPool& operator=(const DcmPool&) = delete;
 
 		/*!
 		 * \fn	Ptr DcmPool::Alloc();
 		 *
-		 * \brief	Allocate an object from the pool.
+		 * \brief	Allocate a default-constructed object from the pool.
+		 * 			Same as calling Emplace() without arguments (requires T to be default constructible).
 		 *
 		 * \author	Ronen
 		 * \date	2/21/2018
@@ -170,10 +265,59 @@ namespace dcm_pool
 		 */
 		Ptr Alloc();
 
+		/*!
+		 * \fn	template <typename... Args> Ptr DcmPool::Emplace(Args&&... args);
+		 *
+		 * \brief	Allocate an object from the pool, and construct it directly in pool's memory with the given arguments.
+		 * 			If the constructor throws, the pool remains unchanged.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	args	Arguments to pass to the object constructor.
+		 *
+		 * \return	An ObjectPtr pointing at the newly-allocated object.
+		 * 			You must keep it to later release the object.
+		 */
+		template <typename... Args>
+		Ptr Emplace(Args&&... args);
+
+		/*!
+		 * \fn	void DcmPool::AllocN(size_t count, Ptr* out_ptrs = NULL);
+		 *
+		 * \brief	Allocate multiple default-constructed objects in a single call.
+		 * 			Fills existing holes first, then claims all remaining objects as a single range at the end of the pool,
+		 * 			so storage grows at most once. OnAlloc is called for all objects after they were all allocated.
+		 * 			Will throw ExceededPoolLimit (without allocating anything) if there's not enough room for all objects,
+		 * 			and if a constructor throws the pool remains unchanged.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	count		How many objects to allocate.
+		 * \param	out_ptrs	Optional array of at least count pointers, to fill with the new objects.
+		 */
+		void AllocN(size_t count, Ptr* out_ptrs = NULL);
+
+#if DCM_POOL_CPP_VERSION >= 202002L
+		/*!
+		 * \fn	void DcmPool::AllocN(std::span<Ptr> out_ptrs);
+		 *
+		 * \brief	Allocate multiple default-constructed objects in a single call, one for every pointer in the given span.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	out_ptrs	Pointers to fill with the new objects.
+		 */
+		void AllocN(std::span<Ptr> out_ptrs) { AllocN(out_ptrs.size(), out_ptrs.data()); }
+#endif
+
 		/*!
 		 * \fn	void DcmPool::Release(ObjectPtr<T> obj);
 		 *
 		 * \brief	Releases the given object and return it to the pool.
+		 * 			The object is destroyed immediately (its destructor is called).
 		 *
 		 * \author	Ronen
 		 * \date	2/21/2018
@@ -186,6 +330,7 @@ namespace dcm_pool
 		* \fn	void DcmPool::Release(ObjectId id);
 		*
 		* \brief	Releases the given object and return it to the pool.
+		* 			The object is destroyed immediately (its destructor is called).
 		*
 		* \author	Ronen
 		* \date	2/21/2018
@@ -194,6 +339,224 @@ namespace dcm_pool
 		*/
 		void Release(ObjectId id);
 
+		/*!
+		* \fn	void DcmPool::ReleaseN(const ObjectId* ids, size_t count);
+		*
+		* \brief	Release multiple objects in a single call.
+		* 			All ids are validated before releasing anything (will throw AccessViolation if any id is not alive,
+		* 			or appears twice). OnRelease is called for all objects before they are destroyed, and in
+		* 			DEFRAG_IMMEDIATE mode all holes are closed with a single defrag, instead of once per object.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	ids		Objects to release.
+		* \param	count	How many ids to release.
+		*/
+		void ReleaseN(const ObjectId* ids, size_t count);
+
+#if DCM_POOL_CPP_VERSION >= 202002L
+		/*!
+		* \fn	void DcmPool::ReleaseN(std::span<const ObjectId> ids);
+		*
+		* \brief	Release multiple objects in a single call.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	ids		Objects to release.
+		*/
+		void ReleaseN(std::span<const ObjectId> ids) { ReleaseN(ids.data(), ids.size()); }
+#endif
+
+		/*!
+		* \fn	bool DcmPool::TryRelease(ObjectId id);
+		*
+		* \brief	Releases the given object if its alive, without throwing exceptions for stale or invalid ids.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	id		Object to release.
+		*
+		* \return	True if object was released, false if id is not a used object.
+		*/
+		bool TryRelease(ObjectId id);
+
+		/*!
+		* \fn	void DcmPool::QueueRelease(ObjectId id);
+		*
+		* \brief	Queue an object to be released by the next ApplyPendingReleases() call.
+		* 			This is the only pool method that is safe to call from any thread, while the pool is used by another
+		* 			thread (its lock-free and never allocates memory per id).
+		* 			Ids are only validated when applied, so its OK to queue the same object more than once.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	id		Object to release.
+		*/
+		void QueueRelease(ObjectId id) { _release_queue.Push(id); }
+
+		/*!
+		* \fn	size_t DcmPool::ApplyPendingReleases();
+		*
+		* \brief	Release all the objects queued with QueueRelease(), in a single batch.
+		* 			Skips ids that are no longer alive and ids that were queued twice, releases the objects in index
+		* 			order (like ReleaseN) and then closes the holes based on defrag mode, like before iterating.
+		* 			Must be called from the thread that uses the pool (usually once per frame, at a sync point).
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \return	How many objects were released.
+		*/
+		size_t ApplyPendingReleases();
+
+		/*!
+		* \fn	bool DcmPool::IsAlive(ObjectId id) const;
+		*
+		* \brief	Check if an object id belongs to a currently used object in pool.
+		* 			This is O(1) and never throws, ids of released objects will always return false (even if their slot
+		* 			was reused by a new object).
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	id		Object id to check.
+		*
+		* \return	True if object is alive, false otherwise.
+		*/
+		bool IsAlive(ObjectId id) const;
+
+		/*!
+		* \fn	T* DcmPool::TryGet(ObjectId id);
+		*
+		* \brief	Get object from id, without throwing exceptions for stale or invalid ids.
+		* 			Note: the returned pointer is only valid until the next defrag or allocation.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	id		Object id to get.
+		*
+		* \return	Pointer to the object, or NULL if id is not a used object.
+		*/
+		T* TryGet(ObjectId id);
+
+		/*!
+		* \fn	const T* DcmPool::TryGet(ObjectId id) const;
+		*
+		* \brief	Get object from id, without throwing exceptions for stale or invalid ids.
+		* 			Note: the returned pointer is only valid until the next defrag or allocation.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	id		Object id to get.
+		*
+		* \return	Pointer to the object, or NULL if id is not a used object.
+		*/
+		const T* TryGet(ObjectId id) const;
+
+		/*!
+		* \fn	inline T& DcmPool::operator[](Handle handle)
+		*
+		* \brief	Get object from a handle, with a single slots table lookup.
+		* 			Will throw AccessViolation if handle doesn't point on a used object.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	The object itself.
+		*/
+		inline T& operator[](Handle handle) { return _objects[GetIndex(handle._get_id())]; }
+
+		/*!
+		* \fn	inline const T& DcmPool::operator[](Handle handle) const
+		*
+		* \brief	Get object from a handle, with a single slots table lookup.
+		* 			Will throw AccessViolation if handle doesn't point on a used object.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	The object itself.
+		*/
+		inline const T& operator[](Handle handle) const { return _objects[GetIndex(handle._get_id())]; }
+
+		/*!
+		* \fn	inline T* DcmPool::TryGet(Handle handle)
+		*
+		* \brief	Get object from a handle, or NULL if handle doesn't point on a used object.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	Pointer to the object, or NULL.
+		*/
+		inline T* TryGet(Handle handle) { return TryGet(handle._get_id()); }
+
+		/*!
+		* \fn	inline const T* DcmPool::TryGet(Handle handle) const
+		*
+		* \brief	Get object from a handle, or NULL if handle doesn't point on a used object.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	Pointer to the object, or NULL.
+		*/
+		inline const T* TryGet(Handle handle) const { return TryGet(handle._get_id()); }
+
+		/*!
+		* \fn	inline bool DcmPool::IsAlive(Handle handle) const
+		*
+		* \brief	Check if a handle points on a currently used object in pool.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	True if object is alive, false otherwise.
+		*/
+		inline bool IsAlive(Handle handle) const { return IsAlive(handle._get_id()); }
+
+		/*!
+		* \fn	inline void DcmPool::Release(Handle handle)
+		*
+		* \brief	Releases the object a handle points on.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object to release.
+		*/
+		inline void Release(Handle handle) { Release(handle._get_id()); }
+
+		/*!
+		* \fn	inline Ptr DcmPool::GetPtr(Handle handle)
+		*
+		* \brief	Get a (caching) pointer to the object a handle points on.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	handle	Object handle.
+		*
+		* \return	Pointer to object.
+		*/
+		inline Ptr GetPtr(Handle handle) { return Ptr(this, handle._get_id()); }
+
 		/*!
 		 * \fn	void DcmPool::Reserve(size_t amount);
 		 *
@@ -221,7 +584,7 @@ namespace dcm_pool
 		void Iterate(PoolIterator<T> callback);
 
 		/*!
-		* \fn	void DcmPool::Iterate(PoolIteratorEx<T> callback);
+		* \fn	void DcmPool::Iterate(PoolIteratorEx<T, Allocator, IdTraits> callback);
 		*
 		* \brief	Iterates all the objects in pool with extended options.
 		* 			Note: if working in deferred defrag mode, this will trigger defrag.
@@ -232,7 +595,7 @@ namespace dcm_pool
 		* \param	callback	The callback to use on the objects while iterating.
 		* 						Return false to break the iteration.
 		*/
-		void IterateEx(PoolIteratorEx<T> callback);
+		void IterateEx(PoolIteratorEx<T, Allocator, IdTraits> callback);
 
 		/*!
 		 * \fn	void DcmPool::Iterate(ConstPoolIterator<T> callback) const;
@@ -249,7 +612,7 @@ namespace dcm_pool
 		void Iterate(ConstPoolIterator<T> callback) const;
 
 		/*!
-		* \fn	void DcmPool::Iterate(ConstPoolIteratorEx<T> callback) const;
+		* \fn	void DcmPool::Iterate(ConstPoolIteratorEx<T, Allocator, IdTraits> callback) const;
 		*
 		* \brief	Iterates all the objects in pool with extended options.
 		* 			Note: if working in deferred defrag mode, this will trigger defrag.
@@ -260,7 +623,63 @@ namespace dcm_pool
 		* \param	callback	The callback to use on the objects while iterating.
 		* 						Return false to break the iteration.
 		*/
-		void IterateEx(ConstPoolIteratorEx<T> callback) const;
+		void IterateEx(ConstPoolIteratorEx<T, Allocator, IdTraits> callback) const;
+
+		/*!
+		 * \fn	template <typename Callback> void DcmPool::ForEach(Callback&& callback);
+		 *
+		 * \brief	Iterates all the objects in pool with any callable (lambdas with captures, functors, function pointers).
+		 * 			Unlike Iterate(), the callback is not called through a function pointer, so it can be inlined into
+		 * 			the loop (and vectorized, if pool have no holes).
+		 * 			The callback may accept (T&), (T&, ObjectId) or (T&, ObjectId, DcmPool&), and may return void or
+		 * 			IterationReturnCode (ITER_BREAK stops the iteration).
+		 * 			Note: don't allocate or release objects from inside the callback, collect them and do it after iteration.
+		 * 			Note: if working in deferred defrag mode, this will trigger defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to use on the objects while iterating.
+		 */
+		template <typename Callback>
+		void ForEach(Callback&& callback);
+
+		/*!
+		 * \fn	template <typename Callback> void DcmPool::ForEach(Callback&& callback) const;
+		 *
+		 * \brief	Iterates all the objects in pool with any callable, without changing them.
+		 * 			Same as the non-const version, but callback gets (const T&) and (const DcmPool&), and will never trigger defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to use on the objects while iterating.
+		 */
+		template <typename Callback>
+		void ForEach(Callback&& callback) const;
+
+		/*!
+		 * \fn	template <typename Callback> void DcmPool::ParallelIterate(Callback&& callback, size_t grain = 0, ThreadPool& workers = ThreadPool::Default());
+		 *
+		 * \brief	Iterates all the objects in pool on multiple threads.
+		 * 			Defrags once (based on defrag mode), then splits the pool into chunks and runs them on a persistent thread pool.
+		 * 			Chunks are multiples of 64 objects, so two threads never share a used-flags word, and chunk boundaries
+		 * 			fall on a cache line whenever the objects storage is cache-line aligned (for example in virtual memory modes).
+		 * 			The callback accepts the same signatures as ForEach(), including the (T&, ObjectId, DcmPool&) one that
+		 * 			returns IterationReturnCode (ITER_BREAK stops remaining chunks, but chunks already running will finish).
+		 * 			Note: callback is called concurrently, so it must be thread safe. Don't allocate, release or defrag while iterating.
+		 * 			Note: if a callback throws, remaining chunks are skipped and the exception is rethrown here.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to use on the objects while iterating.
+		 * \param	grain		How many objects to process per chunk (rounded up to multiple of 64).
+		 * 						0 to pick automatically (about 4 chunks per thread, at least MinParallelIterateGrain).
+		 * \param	workers		Thread pool to run on. Defaults to the library's default thread pool.
+		 */
+		template <typename Callback>
+		void ParallelIterate(Callback&& callback, size_t grain = 0, ThreadPool& workers = ThreadPool::Default());
         
 		/*!
 		 * \fn	void DcmPool::Clear();
@@ -285,6 +704,145 @@ namespace dcm_pool
 		 */
 		inline size_t size() const;
 
+		/*!
+		 * \fn	T* DcmPool::Data();
+		 *
+		 * \brief	Gets direct access to the objects contiguous memory.
+		 * 			The returned pointer points on size() live objects, with no holes between them.
+		 * 			If the pool have holes it will defrag first, or throw PoolNotDefragged if in manual defrag mode.
+		 * 			Will throw StorageNotContiguous if using STORAGE_PAGED mode.
+		 * 			Note: the pointer is only valid until the next allocation or defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Pointer to the first object in pool.
+		 */
+		T* Data();
+
+#if DCM_POOL_CPP_VERSION >= 202002L
+		/*!
+		 * \fn	std::span<T> DcmPool::Span();
+		 *
+		 * \brief	Gets a span over all the live objects in pool.
+		 * 			Same as Data(), eg may defrag or throw PoolNotDefragged / StorageNotContiguous.
+		 * 			Note: the span is only valid until the next allocation or defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Span of live objects.
+		 */
+		std::span<T> Span() { T* data = Data(); return std::span<T>(data, _allocated_objects_count); }
+#endif
+
+		/*!
+		 * \fn	iterator DcmPool::begin();
+		 *
+		 * \brief	Gets an iterator to the first live object, so the pool can be used with range-for and <algorithm>.
+		 * 			Iterators skip holes, so they work in any defrag mode.
+		 * 			Note: if working in deferred defrag mode, this will trigger defrag (like Iterate()).
+		 * 			Note: iterators are invalidated by allocating, releasing or defragging.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Iterator to first live object.
+		 */
+		iterator begin();
+
+		/*!
+		 * \fn	iterator DcmPool::end();
+		 *
+		 * \brief	Gets the end iterator.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	End iterator.
+		 */
+		inline iterator end() { return iterator(); }
+
+		/*!
+		 * \fn	const_iterator DcmPool::begin() const;
+		 *
+		 * \brief	Gets a const iterator to the first live object (never triggers defrag).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Iterator to first live object.
+		 */
+		inline const_iterator begin() const { return const_iterator(&_objects, &_is_used, 0, UsedSize()); }
+
+		/*!
+		 * \fn	const_iterator DcmPool::end() const;
+		 *
+		 * \brief	Gets the const end iterator.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	End iterator.
+		 */
+		inline const_iterator end() const { return const_iterator(); }
+
+		/*!
+		 * \fn	_internal::IteratorsRange<ids_iterator> DcmPool::WithIds();
+		 *
+		 * \brief	Gets a view over live objects that yields (object, id) pairs, for example:
+		 * 			for (auto obj : pool.WithIds()) { obj.first.Update(); if (obj.first.dead) to_remove.push_back(obj.second); }
+		 * 			Note: if working in deferred defrag mode, this will trigger defrag (like Iterate()).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Range of (object, id) pairs.
+		 */
+		_internal::IteratorsRange<ids_iterator> WithIds();
+
+		/*!
+		 * \fn	_internal::IteratorsRange<const_ids_iterator> DcmPool::WithIds() const;
+		 *
+		 * \brief	Gets a view over live objects that yields (const object, id) pairs (never triggers defrag).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Range of (object, id) pairs.
+		 */
+		inline _internal::IteratorsRange<const_ids_iterator> WithIds() const { return _internal::IteratorsRange<const_ids_iterator>(const_ids_iterator(begin(), _ids.data()), const_ids_iterator()); }
+
+		/*!
+		 * \fn	_internal::IteratorsRange<dense_iterator> DcmPool::Dense();
+		 *
+		 * \brief	Gets a random access view over all the live objects, to use with algorithms that require random access
+		 * 			(sort, parallel algorithms with std::execution::par_unseq, std::ranges, etc).
+		 * 			Works with any storage mode. If the pool have holes it will defrag first, or throw PoolNotDefragged
+		 * 			if in manual defrag mode.
+		 * 			Note: reordering objects with this view (for example with sort) does not update the pool, so object
+		 * 			pointers will point on the objects that got moved into their place. Only use it to read or update objects.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Random access range of live objects.
+		 */
+		_internal::IteratorsRange<dense_iterator> Dense();
+
+		/*!
+		 * \fn	_internal::IteratorsRange<const_dense_iterator> DcmPool::Dense() const;
+		 *
+		 * \brief	Gets a random access view over all the live objects of a const pool.
+		 * 			Will throw PoolNotDefragged if the pool have holes.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Random access range of live objects.
+		 */
+		_internal::IteratorsRange<const_dense_iterator> Dense() const;
+
 		/*!
 		 * \fn	T DcmPool::_get_object(ObjectId id);
 		 *
@@ -295,21 +853,76 @@ namespace dcm_pool
 		 *
 		 * \param	id		Object id to get..
 		 *
-		 * \return	The object itself.
+		 * \return	The object itself. Will throw AccessViolation if id is not a used object.
 		 */
 		T& _get_object(ObjectId id);
 
+		/*!
+		 * \fn	T DcmPool::_get_object(ObjectId id, size_t& index);
+		 *
+		 * \brief	Gets an object and its index from id.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id		Object id to get.
+		 * \param	index	Will be set to the object index in pool.
+		 *
+		 * \return	The object itself. Will throw AccessViolation if id is not a used object.
+		 */
+		T& _get_object(ObjectId id, size_t& index);
+
 		/*!
 		 * \fn	void DcmPool::ClearUnusedMemory();
 		 *
-		 * \brief	Force the pool to clear unused memory now.
+		 * \brief	Force the pool to clear unused memory now, and return it to the system (down to the reserved capacity).
 		 * 			This process happens automatically as you release objects, based on shrink_threshold.
+		 * 			Will throw CannotResizeWhileNotDefragged if there are holes in pool.
 		 *
 		 * \author	Ronen
 		 * \date	2/22/2018
 		 */
 		void ClearUnusedMemory();
 
+		/*!
+		 * \fn	inline size_t DcmPool::ReleasedMemoryBytes() const
+		 *
+		 * \brief	Gets how many bytes of memory this pool returned to the system so far, by shrinking.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Total released bytes.
+		 */
+		inline size_t ReleasedMemoryBytes() const { return _released_memory_bytes; }
+
+		/*!
+		 * \fn	inline size_t DcmPool::HugePagesBytes() const
+		 *
+		 * \brief	Gets how many bytes of the objects memory are actually backed by huge pages.
+		 * 			Only meaningful in STORAGE_VIRTUAL_HUGE_PAGES mode, and only supported on Linux (returns 0 elsewhere).
+		 * 			Note: this queries the OS, so don't call it every frame.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Bytes backed by huge pages.
+		 */
+		inline size_t HugePagesBytes() const { return _objects.huge_pages_bytes(); }
+
+		/*!
+		 * \fn	inline bool DcmPool::ExplicitHugePages() const
+		 *
+		 * \brief	Check if the objects memory got explicit huge pages (MAP_HUGETLB, from the system's huge pages pool).
+		 * 			False if not in STORAGE_VIRTUAL_HUGE_PAGES mode, or if the pool fell back to transparent huge pages.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	True if objects memory is backed by explicit huge pages.
+		 */
+		inline bool ExplicitHugePages() const { return _objects.explicit_huge_pages(); }
+
 		/*!
 		* \fn	void DcmPool::Defrag();
 		*
@@ -320,6 +933,60 @@ namespace dcm_pool
 		*/
 		void Defrag();
 
+		/*!
+		* \fn	size_t DcmPool::DefragStep(size_t max_moves);
+		*
+		* \brief	Partially defrags the pool, by moving up to max_moves objects into holes.
+		* 			Next call will continue from where this one stopped. Useful to spread defragging over several frames.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	max_moves	Max objects to move.
+		*
+		* \return	How many holes are left to close (0 means pool is fully defragged).
+		*/
+		size_t DefragStep(size_t max_moves);
+
+		/*!
+		* \fn	size_t DcmPool::DefragFor(std::chrono::microseconds budget);
+		*
+		* \brief	Partially defrags the pool, until there are no more holes or until time budget runs out.
+		* 			Checks the clock every few moves, so it may exceed the budget slightly.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	budget	Time to spend on defragging.
+		*
+		* \return	How many holes are left to close (0 means pool is fully defragged).
+		*/
+		size_t DefragFor(std::chrono::microseconds budget);
+
+		/*!
+		* \fn	inline size_t DcmPool::HolesCount() const
+		*
+		* \brief	Gets how many holes the pool have, eg unused indices between live objects.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \return	Holes count.
+		*/
+		inline size_t HolesCount() const { return _allocated_objects_count ? _max_used_index_in_vector + 1 - _allocated_objects_count : 0; }
+
+		/*!
+		* \fn	inline void DcmPool::SetIncrementalDefragBudget(size_t max_moves)
+		*
+		* \brief	Sets max objects to move on every iteration, when using DEFRAG_INCREMENTAL mode.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \param	max_moves	Max objects to move per iteration (default to DefaultIncrementalDefragMoves).
+		*/
+		inline void SetIncrementalDefragBudget(size_t max_moves) { _incremental_defrag_moves = max_moves; }
+
 		/*!
 		 * \fn	inline unsigned int DcmPool::_get_defrags_count() const
 		 *
@@ -332,12 +999,98 @@ namespace dcm_pool
 		 */
 		inline unsigned int _get_defrags_count() const { return _defrags_count; }
 
+		/*!
+		 * \fn	inline size_t DcmPool::_get_releases_count() const
+		 *
+		 * \brief	Gets how many times objects were released from pool (used internally by pointers).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Releases count.
+		 */
+		inline size_t _get_releases_count() const { return _releases_count; }
+
+		/*!
+		 * \fn	inline bool DcmPool::_moved_since(size_t index, unsigned int defrag_version) const
+		 *
+		 * \brief	Check if the object in a given index might have moved (or was released) since a given defrag version,
+		 * 			so pointers that cached its address at that version need to get it again.
+		 * 			Moves are tracked per page of RelocationPageSize indices, so a defrag only invalidates the cached
+		 * 			pointers of objects near the objects it actually moved (unless all storage moved).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index			Object index when its address was cached.
+		 * \param	defrag_version	Defrag version when object address was cached.
+		 *
+		 * \return	True if object might have moved.
+		 */
+		inline bool _moved_since(size_t index, unsigned int defrag_version) const
+		{
+			// pointers cached before a stamp are invalid (releases stamp the next version, so they also invalidate pointers cached now)
+			// note: compare versions relative to the cached version, so it works when the counter wraps around
+			unsigned int elapsed = _defrags_count - defrag_version;
+			size_t page = index / RelocationPageSize;
+			unsigned int changed_at = page < _pages_changed_at.size() ? _pages_changed_at[page] : _storage_moved_at;
+			return (unsigned int)(_storage_moved_at - defrag_version - 1) <= elapsed || (unsigned int)(changed_at - defrag_version - 1) <= elapsed;
+		}
+
+		/*!
+		 * \fn	size_t DcmPool::_prepare_chunks(size_t& grain, size_t threads_count);
+		 *
+		 * \brief	Prepare to iterate the pool in chunks from multiple threads (used internally by ParallelIterate and SystemsScheduler).
+		 * 			Defrags based on defrag mode, and picks chunk size.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	grain			Objects per chunk (0 to pick automatically). Will be set to the actual chunk size.
+		 * \param	threads_count	How many threads will run the chunks.
+		 *
+		 * \return	Chunks count.
+		 */
+		size_t _prepare_chunks(size_t& grain, size_t threads_count);
+
+		/*!
+		 * \fn	template <typename Callback> bool DcmPool::_iterate_chunk(Callback& callback, size_t chunk, size_t grain);
+		 *
+		 * \brief	Iterate a single chunk, after calling _prepare_chunks() (used internally by ParallelIterate and SystemsScheduler).
+		 * 			Different chunks can be iterated from different threads at the same time.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to use on the objects (same signatures as ForEach()).
+		 * \param	chunk		Chunk index.
+		 * \param	grain		Chunk size, as returned from _prepare_chunks().
+		 *
+		 * \return	False if callback returned ITER_BREAK.
+		 */
+		template <typename Callback>
+		bool _iterate_chunk(Callback& callback, size_t chunk, size_t grain);
+
 	private:
 
+		/*!
+		 * \fn	size_t DcmPool<T>::AllocIndex();
+		 *
+		 * \brief	Find an index to allocate a new object on (fill a hole, or add to the end of the pool).
+		 * 			Will throw ExceededPoolLimit if pool is full.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Index for the new object (not constructed yet).
+		 */
+		size_t AllocIndex();
+
 		/*!
 		 * \fn	Ptr DcmPool<T>::AssignObject(size_t index);
 		 *
 		 * \brief	Assign an object in the pool (internally) and return its object pointer.
+		 * 			Object must already be constructed.
 		 *
 		 * \author	Ronen
 		 * \date	2/22/2018
@@ -348,8 +1101,264 @@ namespace dcm_pool
 		 */
 		Ptr AssignObject(size_t index);
 
+		/*!
+		 * \fn	template <typename Callback> bool DcmPool<T>::ForEachInRange(Callback& callback, size_t begin, size_t end, bool has_holes);
+		 *
+		 * \brief	Call a ForEach() callback for every live object in range [begin, end).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to call.
+		 * \param	begin		First index.
+		 * \param	end			Index to stop at.
+		 * \param	has_holes	If false, we don't check used flags and iterate all objects in range.
+		 *
+		 * \return	False if callback returned ITER_BREAK.
+		 */
+		template <typename Callback>
+		bool ForEachInRange(Callback& callback, size_t begin, size_t end, bool has_holes);
+
+		/*!
+		 * \fn	void DcmPool<T>::DefragIfHoles();
+		 *
+		 * \brief	Make sure the pool have no holes, by defragging it (or throwing PoolNotDefragged in manual defrag mode).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void DefragIfHoles();
+
+		/*!
+		 * \fn	inline size_t DcmPool<T>::UsedSize() const
+		 *
+		 * \brief	Gets the size of the used part of the objects storage (last used object + 1, or 0 if empty).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Used size.
+		 */
+		inline size_t UsedSize() const { return _allocated_objects_count ? _max_used_index_in_vector + 1 : 0; }
+
+		/*!
+		 * \fn	void DcmPool<T>::DefragBeforeIterate();
+		 *
+		 * \brief	Defrag before iterating, based on defrag mode.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void DefragBeforeIterate();
+
+		/*!
+		 * \fn	size_t DcmPool<T>::GetIndex(ObjectId id) const;
+		 *
+		 * \brief	Convert object id to its index in pool's vector.
+		 * 			Will throw AccessViolation if id does not belong to a used object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	Object id to get index for.
+		 *
+		 * \return	Object index in pool's vector.
+		 */
+		size_t GetIndex(ObjectId id) const;
+
+		/*!
+		 * \fn	void DcmPool<T>::ReleaseAt(size_t index, ObjectId id);
+		 *
+		 * \brief	Release an object we already validated and know its index.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Object index in pool's vector.
+		 * \param	id		Object id.
+		 */
+		void ReleaseAt(size_t index, ObjectId id);
+
+		/*!
+		 * \fn	void DcmPool<T>::ReleaseBatch(size_t count);
+		 *
+		 * \brief	Release the objects in _batch_indices, that were already validated.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	count	How many objects to release.
+		 */
+		void ReleaseBatch(size_t count);
+
+		/*!
+		 * \fn	void DcmPool<T>::DefragMoves(size_t max_moves);
+		 *
+		 * \brief	Close holes (up to max_moves objects moved) using the method that fits defrag mode and objects type.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_moves	Max objects to move (ObjectPoolMaxIndex to close all holes).
+		 */
+		void DefragMoves(size_t max_moves);
+
+		/*!
+		 * \fn	void DcmPool<T>::CloseHoles(size_t max_moves, std::false_type relocatable);
+		 *
+		 * \brief	Close holes by moving the last object into every hole, one object at a time.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_moves	Max objects to move.
+		 */
+		void CloseHoles(size_t max_moves, std::false_type relocatable);
+
+		/*!
+		 * \fn	void DcmPool<T>::CloseHoles(size_t max_moves, std::true_type relocatable);
+		 *
+		 * \brief	Close holes of trivially relocatable objects. Matches runs of consecutive holes with runs of
+		 * 			consecutive objects from the end of the pool, and moves every pair of runs with a single memcpy.
+		 * 			Holes we didn't get to (out of budget) are returned to the holes list.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_moves	Max objects to move.
+		 */
+		void CloseHoles(size_t max_moves, std::true_type relocatable);
+
+		/*!
+		 * \fn	void DcmPool<T>::AddHole(size_t index);
+		 *
+		 * \brief	Register a new hole we need to close.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Hole index.
+		 */
+		void AddHole(size_t index);
+
+		/*!
+		 * \fn	void DcmPool<T>::CompactStable(size_t max_moves);
+		 *
+		 * \brief	Close holes while keeping objects order (used in DEFRAG_STABLE mode).
+		 * 			Shifts every run of consecutive objects after the first hole back over the holes, in a single forward pass.
+		 * 			If out of budget, remembers where it stopped as the first hole.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_moves	Max objects to move.
+		 */
+		void CompactStable(size_t max_moves);
+
+		/*!
+		 * \fn	void DcmPool<T>::ShrinkIfNeeded();
+		 *
+		 * \brief	Shrink pool memory if we have more than shrink_threshold unused objects capacity, and no holes.
+		 * 			Keeps half the threshold as free capacity, so pools that oscillate around the same size won't
+		 * 			keep reallocating.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void ShrinkIfNeeded();
+
+		/*!
+		 * \fn	void DcmPool<T>::ShrinkMemory(size_t free_capacity);
+		 *
+		 * \brief	Destroy unused objects at the end of the pool and return their memory to the system.
+		 * 			Must be called when there are no holes.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	free_capacity	Unused capacity to keep for future allocations.
+		 */
+		void ShrinkMemory(size_t free_capacity);
+
+		/*!
+		 * \fn	void DcmPool<T>::StorageMoved();
+		 *
+		 * \brief	Called when storage moved all objects (grew, shrank or was cleared), to invalidate all cached pointers.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void StorageMoved();
+
+		/*!
+		 * \fn	inline void DcmPool<T>::IndexMoved(size_t index)
+		 *
+		 * \brief	Called when the object in index was moved by a defrag (after increasing the defrags count), to
+		 * 			invalidate pointers to its page that were cached before this defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Object index.
+		 */
+		inline void IndexMoved(size_t index) { PageChangedAt(index, _defrags_count); }
+
+		/*!
+		 * \fn	inline void DcmPool<T>::IndexReleased(size_t index)
+		 *
+		 * \brief	Called when the object in index was released, to invalidate pointers to its page that were cached
+		 * 			up to (and including) the current defrag version.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Object index.
+		 */
+		inline void IndexReleased(size_t index) { PageChangedAt(index, _defrags_count + 1); }
+
+		/*!
+		 * \fn	inline void DcmPool<T>::PageChangedAt(size_t index, unsigned int version)
+		 *
+		 * \brief	Mark pointers to the page of index that were cached before a given defrag version as invalid.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Object index.
+		 * \param	version	Defrag version from which cached pointers to page are valid again.
+		 */
+		inline void PageChangedAt(size_t index, unsigned int version)
+		{
+			// pages we never changed are only invalid if storage moved
+			size_t page = index / RelocationPageSize;
+			if (page >= _pages_changed_at.size())
+			{
+				_pages_changed_at.resize(page + 1, _storage_moved_at);
+			}
+			_pages_changed_at[page] = version;
+		}
+
 	};
+
+#if DCM_POOL_CPP_VERSION >= 201703L
+	/*!
+	 * \typedef	DcmPool<T, std::pmr::polymorphic_allocator<T> > PmrDcmPool
+	 *
+	 * \brief	A pool that takes its memory from a std::pmr::memory_resource (pass the resource as the allocator param).
+	 */
+	template <typename T>
+	using PmrDcmPool = DcmPool<T, std::pmr::polymorphic_allocator<T> >;
+#endif
 }
 
 // include implementation
-#include "_dcm_pool_imp.h"
\ No newline at end of file
+#include "_dcm_pool_imp.h"
+
+// include structure-of-arrays pool variant
+#include "soa_pool.h"
+
+// include thread-safe pool variant
+#include "concurrent_pool.h"
+
+// include systems scheduler
+#include "systems_scheduler.h"
@@ -9,15 +9,28 @@
 
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// c++ standard version (msvc only report the actual version via _MSVC_LANG)
+#if defined(_MSVC_LANG)
+#define DCM_POOL_CPP_VERSION _MSVC_LANG
+#else
+#define DCM_POOL_CPP_VERSION __cplusplus
+#endif
 
 
 using namespace std;
 
 namespace dcm_pool
 {
-	// predeclare objects pool
-	template <typename T>
-	class DcmPool;
+	// predeclare structure-of-arrays objects pool
+	template <typename... Fields>
+	class DcmSoaPool;
 
 	/*! \brief	Invalid index / max object id. */
 	const size_t ObjectPoolMaxIndex = std::numeric_limits<std::size_t>::max();
@@ -26,9 +39,91 @@ namespace dcm_pool
 	* \typedef	unsigned int ObjectId
 	*
 	* \brief	Represent an internal object id while in objects pool.
+	* 			The lower bits of the id are the object's slot index, and the upper bits are the slot generation,
+	* 			which changes whenever the slot is allocated or released. This way ids of released objects never
+	* 			match the ids of new objects that reuse their slot.
 	*/
 	typedef size_t ObjectId;
 
+	/*! \brief	How many bits of the object id are used for the slot index (the rest are used for generation). */
+	const size_t ObjectIdSlotBits = sizeof(ObjectId) * 4;
+
+	/*! \brief	Mask to extract slot index from object id. Also used as the max slots count. */
+	const ObjectId ObjectIdSlotMask = (ObjectId(1) << ObjectIdSlotBits) - 1;
+
+	namespace _internal
+	{
+		/*! \brief	Build an object id from slot index and generation. */
+		inline ObjectId make_object_id(size_t slot, size_t generation) { return (ObjectId(generation) << ObjectIdSlotBits) | ObjectId(slot); }
+
+		/*! \brief	Get slot index from object id. */
+		inline size_t get_id_slot(ObjectId id) { return size_t(id & ObjectIdSlotMask); }
+
+		/*! \brief	Get slot generation from object id. */
+		inline size_t get_id_generation(ObjectId id) { return size_t(id >> ObjectIdSlotBits); }
+	}
+
+	/*!
+	* \struct	IdTraits
+	*
+	* \brief	Select the width of the ids and indices a DcmPool stores for every object (in its ids array, slots table
+	* 			and ObjectHandle). Ids are always passed around as ObjectId, but stored in TId.
+	* 			Narrower ids cut the pool's metadata per object, but limit the max objects count (2^TSlotBits - 1, Alloc()
+	* 			throws ExceededPoolLimit beyond it) and the generation bits (TId bits - TSlotBits). As a slot generation
+	* 			grows by two whenever the slot is reused, a slot is retired after it was used 2^(generation bits - 1) times
+	* 			(instead of letting its generation wrap around and stale ids become valid again), so with few generation bits
+	* 			a pool that keeps releasing and allocating objects slowly loses its capacity.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*
+	* \tparam	TId			Unsigned integer type to store ids and indices in.
+	* \tparam	TSlotBits	How many bits of the id are used for the slot index (the rest are used for generation).
+	*/
+	template <typename TId, size_t TSlotBits>
+	struct IdTraits
+	{
+		static_assert(std::is_unsigned<TId>::value && sizeof(TId) <= sizeof(ObjectId), "Ids must be stored in an unsigned integer that fits in ObjectId.");
+		static_assert(TSlotBits > 0 && TSlotBits < sizeof(TId) * 8, "Ids must have bits for both slot index and generation.");
+
+		/*! \brief	Type to store ids and indices in. */
+		typedef TId Id;
+
+		/*! \brief	How many bits of the id are used for the slot index. */
+		static const size_t SlotBits = TSlotBits;
+
+		/*! \brief	Mask to extract slot index from object id. Also used as the max slots count. */
+		static const size_t SlotMask = (size_t(1) << TSlotBits) - 1;
+
+		/*! \brief	Mask to keep slot generation in the generation bits. */
+		static const size_t GenerationMask = size_t(std::numeric_limits<TId>::max()) >> TSlotBits;
+
+		/*! \brief	Invalid index (marks the end of free slots list). */
+		static const size_t InvalidIndex = size_t(std::numeric_limits<TId>::max());
+
+		/*! \brief	Build an object id from slot index and generation. */
+		static inline ObjectId make_id(size_t slot, size_t generation) { return (ObjectId(generation) << TSlotBits) | ObjectId(slot); }
+
+		/*! \brief	Get slot index from object id. */
+		static inline size_t get_slot(ObjectId id) { return size_t(id & SlotMask); }
+
+		/*! \brief	Get slot generation from object id. */
+		static inline size_t get_generation(ObjectId id) { return size_t(id >> TSlotBits); }
+	};
+
+	/*! \brief	Default ids: ObjectId wide, half of the bits for slot index and half for generation. */
+	typedef IdTraits<ObjectId, ObjectIdSlotBits> DefaultIdTraits;
+
+	/*! \brief	32-bit ids: up to 16M objects, 8 bits generation. */
+	typedef IdTraits<uint32_t, 24> CompactIdTraits;
+
+	/*! \brief	16-bit ids: up to 4095 objects, 4 bits generation. */
+	typedef IdTraits<uint16_t, 12> TinyIdTraits;
+
+	// predeclare objects pool
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
+	class DcmPool;
+
 	/*!
 	* \enum	IterationReturnCode
 	*
@@ -45,8 +140,8 @@ namespace dcm_pool
 	*
 	* \brief	Callback used to iterate objects pool with extended options.
 	*/
-	template <typename T>
-	using PoolIteratorEx = IterationReturnCode(*)(T&, ObjectId, DcmPool<T>&);
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
+	using PoolIteratorEx = IterationReturnCode(*)(T&, ObjectId, DcmPool<T, Allocator, IdTraits>&);
 
 	/*!
 	* \typedef	void(*pool_iterator)(T&, ObjectId)
@@ -61,8 +156,8 @@ namespace dcm_pool
 	*
 	* \brief	Callback used to iterate objects pool with extended options.
 	*/
-	template <typename T>
-	using ConstPoolIteratorEx = IterationReturnCode(*)(const T&, ObjectId, const DcmPool<T>&);
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
+	using ConstPoolIteratorEx = IterationReturnCode(*)(const T&, ObjectId, const DcmPool<T, Allocator, IdTraits>&);
 
 	/*!
 	* \typedef	void(*pool_iterator)(const T&, ObjectId)
@@ -72,9 +167,53 @@ namespace dcm_pool
 	template <typename T>
 	using ConstPoolIterator = void(*)(const T&, ObjectId);
 
+	namespace _internal
+	{
+		/*! \brief	Used to pick the iteration callback overload with the most parameters (higher rank is preferred). */
+		template <size_t N> struct CallbackRank : CallbackRank<N - 1> {};
+		template <> struct CallbackRank<0> {};
+
+		/*! \brief	Call an iteration callback that returns nothing. Always continue iterating. */
+		template <typename Callback, typename... Args>
+		inline typename std::enable_if<std::is_void<decltype(std::declval<Callback&>()(std::declval<Args&>()...))>::value, bool>::type
+			call_iteration_callback(Callback& callback, Args&... args) { callback(args...); return true; }
+
+		/*! \brief	Call an iteration callback that returns IterationReturnCode. Continue iterating unless it returned ITER_BREAK. */
+		template <typename Callback, typename... Args>
+		inline typename std::enable_if<!std::is_void<decltype(std::declval<Callback&>()(std::declval<Args&>()...))>::value, bool>::type
+			call_iteration_callback(Callback& callback, Args&... args) { return callback(args...) != ITER_BREAK; }
+
+		/*! \brief	Invoke an iteration callback that accepts (object, id, pool). */
+		template <typename Callback, typename Object, typename Pool>
+		inline auto invoke_iteration_callback(Callback& callback, Object& object, ObjectId id, Pool& pool, CallbackRank<2>)
+			-> decltype(callback(object, id, pool), bool()) { return call_iteration_callback(callback, object, id, pool); }
+
+		/*! \brief	Invoke an iteration callback that accepts (object, id). */
+		template <typename Callback, typename Object, typename Pool>
+		inline auto invoke_iteration_callback(Callback& callback, Object& object, ObjectId id, Pool&, CallbackRank<1>)
+			-> decltype(callback(object, id), bool()) { return call_iteration_callback(callback, object, id); }
+
+		/*! \brief	Invoke an iteration callback that accepts just the object. */
+		template <typename Callback, typename Object, typename Pool>
+		inline auto invoke_iteration_callback(Callback& callback, Object& object, ObjectId, Pool&, CallbackRank<0>)
+			-> decltype(callback(object), bool()) { return call_iteration_callback(callback, object); }
+	}
+
 	/*! \brief	Callback to handle different pool events like allocating new object or releasing an object. */
-	template <typename T>
-	using EventsHandler = void(*)(T&, ObjectId, DcmPool<T>&);
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
+	using EventsHandler = void(*)(T&, ObjectId, DcmPool<T, Allocator, IdTraits>&);
+
+	/*!
+	* \typedef	void(*soa_pool_iterator)(Fields&..., ObjectId)
+	*
+	* \brief	A simple callback used to iterate all the columns of a structure-of-arrays pool.
+	*/
+	template <typename... Fields>
+	using SoaPoolIterator = void(*)(Fields&..., ObjectId);
+
+	/*! \brief	Callback to handle structure-of-arrays pool events like allocating new object or releasing an object. */
+	template <typename... Fields>
+	using SoaEventsHandler = void(*)(ObjectId, DcmSoaPool<Fields...>&);
     
 	/*!
 	* \enum	DefragModes
@@ -92,5 +231,75 @@ namespace dcm_pool
 
 		/* \brief	Will never call defragging automatically, you need to call Defrag() yourself. */
 		DEFRAG_MANUAL,
+
+		/* \brief	Like DEFRAG_DEFERRED, but keeps objects in the order they were allocated. New objects are always added at
+		the end of the pool (never fill holes), and defragging shifts objects back over the holes in a single forward pass
+		instead of moving the last objects into them. Defragging costs O(objects after first hole) instead of O(holes). */
+		DEFRAG_STABLE,
+
+		/* \brief	Like DEFRAG_DEFERRED, but every iteration only closes a limited number of holes (see SetIncrementalDefragBudget()),
+		so the cost of defragging is spread over several frames instead of spiking. Iteration still skips the holes we didn't close yet. */
+		DEFRAG_INCREMENTAL,
+	};
+
+	/*! \brief	Default max objects to move on every iteration, when using DEFRAG_INCREMENTAL mode. */
+	const size_t DefaultIncrementalDefragMoves = 256;
+
+	/*! \brief	How many pool indices share a single relocation counter, that tells cached object pointers if their object moved. */
+	const size_t RelocationPageSize = 16;
+
+	/*! \brief	Default how many indices and slots a ConcurrentDcmPool::ThreadCache takes from the shared pool at once. */
+	const size_t DefaultThreadCacheBatch = 256;
+
+	/*! \brief	Minimum objects per chunk when ParallelIterate() picks the chunk size, so tiny chunks won't cost more than they save. */
+	const size_t MinParallelIterateGrain = 1024;
+
+	/*! \brief	How many times in a row a SystemsScheduler worker looks for tasks and yields, before it sleeps until new tasks are queued. */
+	const size_t SchedulerIdleRoundsBeforeSleep = 64;
+
+	/*!
+	* \enum	StorageModes
+	*
+	* \brief	Different ways the pool can store its objects in memory.
+	*/
+	enum StorageModes
+	{
+		/* \brief	Store all objects in a single contiguous memory block, which grows by reallocating (and moving all objects). */
+		STORAGE_CONTIGUOUS,
+
+		/* \brief	Store objects in fixed-size pages of StoragePageSize objects. Growing adds a new page and never moves
+		existing objects, and iteration is contiguous per page. */
+		STORAGE_PAGED,
+
+		/* \brief	Reserve address space for max_size objects up front and commit memory as the pool grows. Storage is a
+		single contiguous block that never moves objects when growing. Requires max_size (otherwise same as STORAGE_CONTIGUOUS). */
+		STORAGE_VIRTUAL,
+
+		/* \brief	Same as STORAGE_VIRTUAL, but back the reserved range with huge pages to reduce TLB misses when iterating
+		large pools. Will try explicit huge pages first (MAP_HUGETLB) and fall back to transparent huge pages (MADV_HUGEPAGE).
+		Use DcmPool::HugePagesBytes() to check if huge pages were actually obtained. */
+		STORAGE_VIRTUAL_HUGE_PAGES,
+	};
+
+	/*! \brief	How many objects are stored in every page when using STORAGE_PAGED mode (must be a power of 2). */
+	const size_t StoragePageSize = 16 * 1024;
+
+	/*!
+	* \struct	IsTriviallyRelocatable
+	*
+	* \brief	Tells the pool if objects of type T can be moved in memory with a plain memcpy, without calling their
+	* 			move constructor and destructor. When true, the pool moves objects in bulk when defragging and grows
+	* 			contiguous storage with realloc. Default to true for trivially copyable types.
+	* 			You can specialize it for your own types that are safe to move bitwise (for example types holding
+	* 			unique_ptr or vector members), but never for types that keep pointers into themselves.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*
+	* \tparam	T	Type of objects in pool.
+	*/
+	template <typename T>
+	struct IsTriviallyRelocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+	{
 	};
-}
\ No newline at end of file
+}
@@ -61,6 +61,38 @@ namespace dcm_pool
 		}
 	};
 
+	/*!
+	* \struct	PoolNotDefragged
+	*
+	* \brief	Raised for when someone tries to access pool as contiguous memory but it has holes to defrag.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*/
+	struct PoolNotDefragged : public std::exception
+	{
+		const char * what() const throw ()
+		{
+			return "Cannot access pool as contiguous memory while there are holes to defrag!";
+		}
+	};
+
+	/*!
+	* \struct	StorageNotContiguous
+	*
+	* \brief	Raised for when someone tries to access pool as a single memory block, but its storage is paged.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*/
+	struct StorageNotContiguous : public std::exception
+	{
+		const char * what() const throw ()
+		{
+			return "Cannot access paged pool storage as a single memory block!";
+		}
+	};
+
 	/*!
 	* \struct	InternalError
 	*
@@ -11,7 +11,6 @@
 #pragma once
 
 #include <vector>
-#include "object_in_pool.h"
 #include "defs.h"
 
 
@@ -21,18 +20,27 @@ namespace dcm_pool
 {
 	namespace _internal
 	{
+		/*! \brief	Get the next hole index stored in a free object id. */
+		template <typename Id, typename IdsAllocator>
+		inline size_t get_hole_link(const vector<Id, IdsAllocator>& ids, size_t index) { return ids[index]; }
+
+		/*! \brief	Store the next hole index in a free object id. */
+		template <typename Id, typename IdsAllocator>
+		inline void set_hole_link(vector<Id, IdsAllocator>& ids, size_t index, size_t next) { ids[index] = (Id)next; }
+
 		/*!
 		* \class	DcmPool
 		*
 		* \brief	An internal object used to hold a vector of holes in a pool, without wasting any additional memory.
-		* 			This list makes use of the objects-in-pool header of the already free objects.
+		* 			This list makes use of the ids of the already free objects.
 		*
 		* \author	Ronen
 		* \date	2/21/2018
 		*
-		* \tparam	T	Type of objects to place in pool.
+		* \tparam	TLinks	Type of container used to store the links between holes (normally the pool's vector of object ids).
+		* 					Accessed via get_hole_link() and set_hole_link().
 		*/
-		template <typename T>
+		template <typename TLinks>
 		class HolesList
 		{
 		private:
@@ -43,22 +51,22 @@ namespace dcm_pool
 			// the first index used to store holes in the vector
 			size_t _first_index;
 
-			// the actual vector of objects we use.
-			vector<ObjectInPool<T> >& _objects;
+			// the actual vector of objects (or ids) we use to store links.
+			TLinks& _links;
 
 		public:
 
 			/*!
-			 * \fn	HolesList::HolesList(vector<ObjectInPool<T> >& objects)
+			 * \fn	HolesList::HolesList(TLinks& links)
 			 *
 			 * \brief	Constructor
 			 *
 			 * \author	Ronen
 			 * \date	3/8/2018
 			 *
-			 * \param [in,out]	objects	The objects.
+			 * \param [in,out]	links	The objects (or ids) to store links in.
 			 */
-			HolesList(vector<ObjectInPool<T> >& objects) : _objects(objects), _size(0) { }
+			HolesList(TLinks& links) : _size(0), _links(links) { }
 
 			/*!
 			 * \fn	inline size_t HolesList::size() const
@@ -0,0 +1,276 @@
+/*!
+* \file	include\dcm_pool\iterators.h.
+*
+* \brief		STL-style iterators and ranges over the live objects in pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include "defs.h"
+#if DCM_POOL_CPP_VERSION >= 202002L
+#include <ranges>
+#endif
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	LiveObjectsIterator
+		*
+		* \brief	Forward iterator over the live objects in pool, that skips holes using the used objects bitmap.
+		* 			Works on any pool, defragged or not. Invalidated by allocating, releasing or defragging.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	T		Object type (const T for const iterators).
+		* \tparam	Storage	Objects storage type (const for const iterators).
+		* \tparam	Bitmap	Used objects bitmap type.
+		*/
+		template <typename T, typename Storage, typename Bitmap>
+		class LiveObjectsIterator
+		{
+		private:
+
+			// objects storage and used objects bitmap.
+			Storage* _objects;
+			const Bitmap* _is_used;
+
+			// current index, or ObjectPoolMaxIndex when done.
+			size_t _index;
+
+			// index to stop at (last used object + 1).
+			size_t _end;
+
+		public:
+
+			typedef std::forward_iterator_tag iterator_category;
+			typedef typename std::remove_const<T>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T* pointer;
+			typedef T& reference;
+
+			/*!
+			 * \fn	LiveObjectsIterator::LiveObjectsIterator(Storage* objects = NULL, const Bitmap* is_used = NULL, size_t index = ObjectPoolMaxIndex, size_t end = 0)
+			 *
+			 * \brief	Constructor. Will move to the first used object from index.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	objects	Objects storage.
+			 * \param	is_used	Used objects bitmap.
+			 * \param	index	Index to start from (ObjectPoolMaxIndex for end iterator).
+			 * \param	end		Index to stop at.
+			 */
+			LiveObjectsIterator(Storage* objects = NULL, const Bitmap* is_used = NULL, size_t index = ObjectPoolMaxIndex, size_t end = 0) :
+				_objects(objects), _is_used(is_used), _index(index), _end(end) { skip_holes(); }
+
+			/*! \brief	Access current object. */
+			inline T& operator*() const { return (*_objects)[_index]; }
+			inline T* operator->() const { return &(*_objects)[_index]; }
+
+			/*! \brief	Move to next live object. */
+			inline LiveObjectsIterator& operator++() { _index++; skip_holes(); return *this; }
+			inline LiveObjectsIterator operator++(int) { LiveObjectsIterator ret = *this; ++(*this); return ret; }
+
+			/*! \brief	Compare iterators. */
+			inline bool operator==(const LiveObjectsIterator& other) const { return _index == other._index; }
+			inline bool operator!=(const LiveObjectsIterator& other) const { return _index != other._index; }
+
+			/*! \brief	Get current object index in pool (internal). */
+			inline size_t _get_index() const { return _index; }
+
+		private:
+
+			// find the next used index from current index. when done, set index to ObjectPoolMaxIndex so all end iterators
+			// compare equal, even if they were taken before the pool was defragged.
+			inline void skip_holes()
+			{
+				if (_index == ObjectPoolMaxIndex) return;
+				_index = _is_used->find_next(_index, _end);
+				if (_index == _end) _index = ObjectPoolMaxIndex;
+			}
+		};
+
+		/*!
+		* \class	LiveObjectsWithIdsIterator
+		*
+		* \brief	Forward iterator over the live objects in pool that yields (object, id) pairs, and skips holes.
+		* 			Dereferencing returns a pair by value (object reference and its id), so it can't be used with operator->.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	T		Object type (const T for const iterators).
+		* \tparam	Storage	Objects storage type (const for const iterators).
+		* \tparam	Bitmap	Used objects bitmap type.
+		* \tparam	Id		Type the object ids are stored in.
+		*/
+		template <typename T, typename Storage, typename Bitmap, typename Id = ObjectId>
+		class LiveObjectsWithIdsIterator
+		{
+		private:
+
+			// objects iterator.
+			LiveObjectsIterator<T, Storage, Bitmap> _iter;
+
+			// object ids, by index.
+			const Id* _ids;
+
+		public:
+
+			typedef std::input_iterator_tag iterator_category;
+#if DCM_POOL_CPP_VERSION >= 202002L
+			typedef std::forward_iterator_tag iterator_concept;
+#endif
+			typedef std::pair<T&, ObjectId> value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;
+			typedef std::pair<T&, ObjectId> reference;
+
+			/*!
+			 * \fn	LiveObjectsWithIdsIterator::LiveObjectsWithIdsIterator(const LiveObjectsIterator<T, Storage, Bitmap>& iter = LiveObjectsIterator<T, Storage, Bitmap>(), const Id* ids = NULL)
+			 *
+			 * \brief	Constructor.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	iter	Objects iterator to wrap.
+			 * \param	ids		Object ids array.
+			 */
+			LiveObjectsWithIdsIterator(const LiveObjectsIterator<T, Storage, Bitmap>& iter = LiveObjectsIterator<T, Storage, Bitmap>(), const Id* ids = NULL) :
+				_iter(iter), _ids(ids) { }
+
+			/*! \brief	Access current object and its id. */
+			inline reference operator*() const { return reference(*_iter, ObjectId(_ids[_iter._get_index()])); }
+
+			/*! \brief	Move to next live object. */
+			inline LiveObjectsWithIdsIterator& operator++() { ++_iter; return *this; }
+			inline LiveObjectsWithIdsIterator operator++(int) { LiveObjectsWithIdsIterator ret = *this; ++_iter; return ret; }
+
+			/*! \brief	Compare iterators. */
+			inline bool operator==(const LiveObjectsWithIdsIterator& other) const { return _iter == other._iter; }
+			inline bool operator!=(const LiveObjectsWithIdsIterator& other) const { return _iter != other._iter; }
+		};
+
+		/*!
+		* \class	DenseObjectsIterator
+		*
+		* \brief	Random access iterator over the objects of a pool with no holes (index 0 to size - 1).
+		* 			Works with any storage mode. Invalidated by allocating, releasing or defragging.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	T		Object type (const T for const iterators).
+		* \tparam	Storage	Objects storage type (const for const iterators).
+		*/
+		template <typename T, typename Storage>
+		class DenseObjectsIterator
+		{
+		private:
+
+			// objects storage.
+			Storage* _objects;
+
+			// current index.
+			std::ptrdiff_t _index;
+
+		public:
+
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef typename std::remove_const<T>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T* pointer;
+			typedef T& reference;
+
+			/*!
+			 * \fn	DenseObjectsIterator::DenseObjectsIterator(Storage* objects = NULL, std::ptrdiff_t index = 0)
+			 *
+			 * \brief	Constructor.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	objects	Objects storage.
+			 * \param	index	Object index.
+			 */
+			DenseObjectsIterator(Storage* objects = NULL, std::ptrdiff_t index = 0) : _objects(objects), _index(index) { }
+
+			/*! \brief	Access objects. */
+			inline T& operator*() const { return (*_objects)[_index]; }
+			inline T* operator->() const { return &(*_objects)[_index]; }
+			inline T& operator[](difference_type offset) const { return (*_objects)[_index + offset]; }
+
+			/*! \brief	Move iterator. */
+			inline DenseObjectsIterator& operator++() { _index++; return *this; }
+			inline DenseObjectsIterator operator++(int) { DenseObjectsIterator ret = *this; _index++; return ret; }
+			inline DenseObjectsIterator& operator--() { _index--; return *this; }
+			inline DenseObjectsIterator operator--(int) { DenseObjectsIterator ret = *this; _index--; return ret; }
+			inline DenseObjectsIterator& operator+=(difference_type offset) { _index += offset; return *this; }
+			inline DenseObjectsIterator& operator-=(difference_type offset) { _index -= offset; return *this; }
+			inline DenseObjectsIterator operator+(difference_type offset) const { return DenseObjectsIterator(_objects, _index + offset); }
+			inline DenseObjectsIterator operator-(difference_type offset) const { return DenseObjectsIterator(_objects, _index - offset); }
+			inline friend DenseObjectsIterator operator+(difference_type offset, const DenseObjectsIterator& iter) { return iter + offset; }
+			inline difference_type operator-(const DenseObjectsIterator& other) const { return _index - other._index; }
+
+			/*! \brief	Compare iterators. */
+			inline bool operator==(const DenseObjectsIterator& other) const { return _index == other._index; }
+			inline bool operator!=(const DenseObjectsIterator& other) const { return _index != other._index; }
+			inline bool operator<(const DenseObjectsIterator& other) const { return _index < other._index; }
+			inline bool operator>(const DenseObjectsIterator& other) const { return _index > other._index; }
+			inline bool operator<=(const DenseObjectsIterator& other) const { return _index <= other._index; }
+			inline bool operator>=(const DenseObjectsIterator& other) const { return _index >= other._index; }
+		};
+
+		/*!
+		* \class	IteratorsRange
+		*
+		* \brief	A simple range of two iterators, so views can be used with range-for, <algorithm> and std::ranges.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Iterator	Iterator type.
+		*/
+		template <typename Iterator>
+		class IteratorsRange
+		{
+		private:
+
+			// range begin and end.
+			Iterator _begin;
+			Iterator _end;
+
+		public:
+
+			/*! \brief	Constructor. */
+			IteratorsRange(const Iterator& begin, const Iterator& end) : _begin(begin), _end(end) { }
+
+			/*! \brief	Get range begin and end. */
+			inline Iterator begin() const { return _begin; }
+			inline Iterator end() const { return _end; }
+		};
+	}
+}
+
+#if DCM_POOL_CPP_VERSION >= 202002L
+// ranges iterators don't point into the range object itself, so they remain valid after it dies
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_borrowed_range<dcm_pool::_internal::IteratorsRange<Iterator> > = true;
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_view<dcm_pool::_internal::IteratorsRange<Iterator> > = true;
+#endif
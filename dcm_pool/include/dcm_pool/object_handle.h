@@ -0,0 +1,128 @@
+/*!
+* \file	include\dcm_pool\object_handle.h.
+*
+* \brief		Define the ObjectHandle template class.
+* 				A compact handle to an object inside the objects pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+#pragma once
+#include "object_ptr.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	/*!
+	 * \class	ObjectHandle
+	 *
+	 * \brief	A compact handle to an object inside the fast objects pool: just the object id (slot index + slot
+	 * 			generation), stored in the pool's id type (8 bytes on 64-bit by default, 4 bytes with CompactIdTraits).
+	 * 			Unlike ObjectPtr, a handle doesn't know its pool or cache the object address, so you access the object
+	 * 			via the pool (pool[handle], or pool.TryGet(handle)), which costs a single slots table lookup.
+	 * 			The handle is bound to its pool by type, so it can't be used with pools of other object types.
+	 *
+	 * 			Use handles for objects that store many references to other objects (graphs, parent links, etc.),
+	 * 			and ObjectPtr for pointers you use often.
+	 * 			Note: to store handles inside the pooled type itself, use ObjectHandle<T> (with the pool's allocator and
+	 * 			id traits) and not DcmPool<T>::Handle, as the pool type can't be used before T is complete.
+	 *
+	 * \author	Ronen
+	 * \date	10/16/2026
+	 *
+	 * \tparam	T			Base object type that you store in pool.
+	 * \tparam	Allocator	The pool's allocator type.
+	 * \tparam	IdTraits	The pool's ids width and layout.
+	 */
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
+	class ObjectHandle
+	{
+	private:
+
+		/*! \brief	The object's unique id. */
+		typename IdTraits::Id _id;
+
+	public:
+
+		/*!
+		 * \fn	ObjectHandle::ObjectHandle(ObjectId id = ObjectPoolMaxIndex)
+		 *
+		 * \brief	Constructor. Default handle doesn't point on any object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	Object's unique id in pool.
+		 */
+		explicit ObjectHandle(ObjectId id = ObjectPoolMaxIndex) : _id((typename IdTraits::Id)id) { }
+
+		/*!
+		 * \fn	ObjectHandle::ObjectHandle(const ObjectPtr<T, Allocator, IdTraits>& ptr)
+		 *
+		 * \brief	Create a handle from a pointer to the same object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	ptr	Pointer to object.
+		 */
+		ObjectHandle(const ObjectPtr<T, Allocator, IdTraits>& ptr) : _id((typename IdTraits::Id)ptr._get_id()) { }
+
+		/*!
+		 * \fn	inline ObjectId ObjectHandle::_get_id() const
+		 *
+		 * \brief	Gets the object id in pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Return the object id.
+		 */
+		inline ObjectId _get_id() const { return IsEmpty() ? ObjectPoolMaxIndex : ObjectId(_id); }
+
+		/*!
+		 * \fn	inline bool ObjectHandle::IsEmpty() const
+		 *
+		 * \brief	Check if this handle was never set to an object (doesn't check if object is still alive, use
+		 * 			pool.IsAlive(handle) for that).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	True if handle is empty.
+		 */
+		inline bool IsEmpty() const { return _id == std::numeric_limits<typename IdTraits::Id>::max(); }
+
+		/*!
+		 * \fn	inline bool ObjectHandle::operator==(const ObjectHandle<T, Allocator, IdTraits>& other) const
+		 *
+		 * \brief	Equality operator.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	other	The other handle to compare to.
+		 *
+		 * \return	True if both handles point on the same object.
+		 */
+		inline bool operator==(const ObjectHandle<T, Allocator, IdTraits>& other) const { return _id == other._id; }
+
+		/*!
+		 * \fn	inline bool ObjectHandle::operator!=(const ObjectHandle<T, Allocator, IdTraits>& other) const
+		 *
+		 * \brief	Inequality operator.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	other	The other handle to compare to.
+		 *
+		 * \return	True if handles point on different objects.
+		 */
+		inline bool operator!=(const ObjectHandle<T, Allocator, IdTraits>& other) const { return _id != other._id; }
+	};
+}
@@ -10,7 +10,6 @@
 
 #pragma once
 #include "object_ptr.h"
-#include "object_in_pool.h"
 #include "defs.h"
 
 
@@ -28,15 +27,17 @@ namespace dcm_pool
 	 * \author	Ronen
 	 * \date	2/21/2018
 	 *
-	 * \tparam	T	Base object type that you store in pool.
+	 * \tparam	T			Base object type that you store in pool.
+	 * \tparam	Allocator	The pool's allocator type.
+	 * \tparam	IdTraits	The pool's ids width and layout.
 	 */
-	template <typename T>
+	template <typename T, typename Allocator = std::allocator<T>, typename IdTraits = DefaultIdTraits>
 	class ObjectPtr
 	{
 	private:
 
 		/*! \brief	The pool containing this object. */
-		DcmPool<T>* _pool;
+		DcmPool<T, Allocator, IdTraits>* _pool;
 
 		/*! \brief	The object's unique id. */
 		ObjectId _id;
@@ -44,9 +45,15 @@ namespace dcm_pool
 		/*! \brief	Saving a cache of the actual object pointer. */
 		T* _cached_ptr;
 
+		/*! \brief	Pool releases count when we cached the pointer (if nothing was released, object is still alive). */
+		size_t _pool_releases_count;
+
 		/*! \brief	Last pool version to indicate if cached pointer is still valid to use. */
 		unsigned int _pool_defrag_version;
 
+		/*! \brief	Object index in pool when we cached its pointer, to check if it moved (fits 32 bits, as every object takes an id slot). */
+		unsigned int _cached_index;
+
 	public:
 
 		/*!
@@ -60,7 +67,7 @@ namespace dcm_pool
 		 * \param	pool	The parent objects pool.
 		 * \param	id		Object's unique id in pool.
 		 */
-		ObjectPtr(DcmPool<T>* pool = NULL, ObjectId id = ObjectPoolMaxIndex);
+		ObjectPtr(DcmPool<T, Allocator, IdTraits>* pool = NULL, ObjectId id = ObjectPoolMaxIndex);
 
 		/*!
 		 * \fn	inline ObjectId ObjectPtr::_get_id() const;
@@ -74,10 +81,24 @@ namespace dcm_pool
 		 */
 		inline ObjectId _get_id() const;
 
+		/*!
+		 * \fn	inline bool ObjectPtr::IsAlive() const;
+		 *
+		 * \brief	Check if the object this pointer points on is still alive in pool.
+		 * 			This is O(1) and detects stale pointers even if the object's slot was reused.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	True if object is alive, false if released or pointer is empty.
+		 */
+		inline bool IsAlive() const;
+
 		/*!
 		 * \fn	T ObjectPtr::*operator*(void) const;
 		 *
 		 * \brief	Return the object itself.
+		 * 			Will throw AccessViolation if object was released (even if its slot was reused by a new object).
 		 *
 		 * \author	Ronen
 		 * \date	2/22/2018
@@ -99,7 +120,7 @@ namespace dcm_pool
 		T* operator->(void);
 
 		/*!
-		 * \fn	inline bool ObjectPtr::operator==(const ObjectPtr<T>& other) const
+		 * \fn	inline bool ObjectPtr::operator==(const ObjectPtr<T, Allocator, IdTraits>& other) const
 		 *
 		 * \brief	Equality operator.
 		 *
@@ -110,10 +131,10 @@ namespace dcm_pool
 		 *
 		 * \return	True if the parameters are considered equivalent.
 		 */
-		inline bool operator==(const ObjectPtr<T>& other) const { _id == other._id && _pool == other._pool; }
+		inline bool operator==(const ObjectPtr<T, Allocator, IdTraits>& other) const { return _id == other._id && _pool == other._pool; }
 
 		/*!
-		 * \fn	inline bool ObjectPtr::operator!=(const ObjectPtr<T>& other) const
+		 * \fn	inline bool ObjectPtr::operator!=(const ObjectPtr<T, Allocator, IdTraits>& other) const
 		 *
 		 * \brief	Inequality operator.
 		 *
@@ -124,10 +145,10 @@ namespace dcm_pool
 		 *
 		 * \return	True if the parameters are not considered equivalent.
 		 */
-		inline bool operator!=(const ObjectPtr<T>& other) const { return !(*this == other); }
+		inline bool operator!=(const ObjectPtr<T, Allocator, IdTraits>& other) const { return !(*this == other); }
 
 		/*!
-		 * \fn	inline void ObjectPtr::operator=(const ObjectPtr<T>& other)
+		 * \fn	inline void ObjectPtr::operator=(const ObjectPtr<T, Allocator, IdTraits>& other)
 		 *
 		 * \brief	Assignment operator.
 		 *
@@ -137,15 +158,19 @@ namespace dcm_pool
 		 * \param	other	Other pointer to assign.
 		 */
 
-		inline void operator=(const ObjectPtr<T>& other) {
+		inline void operator=(const ObjectPtr<T, Allocator, IdTraits>& other) {
 			_id = other._id; 
 			_pool = other._pool;
+			_cached_ptr = other._cached_ptr;
+			_pool_releases_count = other._pool_releases_count;
+			_pool_defrag_version = other._pool_defrag_version;
+			_cached_index = other._cached_index;
 		}
 
 		/*!
-		 * \fn	inline void ObjectPtr::_set_cached_ptr(T* ptr, unsigned int defrag_version)
+		 * \fn	inline void ObjectPtr::_set_cached_ptr(T* ptr, size_t index, unsigned int defrag_version, size_t releases_count)
 		 *
-		 * \brief	Sets cached pointer and defrag version.
+		 * \brief	Sets cached pointer, object index, defrag version and releases count.
 		 * 			We use this to populate the pointer upon creation, since we already know the object address
 		 * 			at this point and its very likely that the user will want to use the pointer immediately after
 		 * 			getting it (to init the object).
@@ -154,11 +179,15 @@ namespace dcm_pool
 		 * \date	2/23/2018
 		 *
 		 * \param [in,out]	ptr			  	Object pointer.
+		 * \param 		  	index		  	Object index in pool.
 		 * \param 		  	defrag_version	The pool's defrag version.
+		 * \param 		  	releases_count	The pool's releases count.
 		 */
-		inline void _set_cached_ptr(T* ptr, unsigned int defrag_version) { 
+		inline void _set_cached_ptr(T* ptr, size_t index, unsigned int defrag_version, size_t releases_count) { 
 			_cached_ptr = ptr; 
+			_cached_index = (unsigned int)index;
 			_pool_defrag_version = defrag_version; 
+			_pool_releases_count = releases_count;
 		}
 	};
 }
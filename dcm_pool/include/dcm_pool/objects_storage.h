@@ -0,0 +1,451 @@
+/*!
+* \file	include\dcm_pool\objects_storage.h.
+*
+* \brief		An internal memory storage for the objects in pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "virtual_memory.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	ObjectsStorage
+		*
+		* \brief	An internal object used to hold the objects memory of a pool.
+		* 			Objects are stored in a table of pages, where every page is a contiguous block of objects:
+		* 				- In STORAGE_CONTIGUOUS mode there's only one page, which grows by reallocating (like a vector).
+		* 				- In STORAGE_PAGED mode every page holds StoragePageSize objects, and growing adds a new page
+		* 				  without moving existing objects.
+		* 				- In STORAGE_VIRTUAL mode there's only one page, which is an address range reserved up front for
+		* 				  the max amount of objects. Growing commits more of the range, without moving existing objects.
+		* 				- STORAGE_VIRTUAL_HUGE_PAGES is the same as STORAGE_VIRTUAL, but the range is backed by huge pages.
+		* 			In all cases accessing object by index is the same shift-and-mask calculation, so there's no
+		* 			branching on storage mode when accessing objects.
+		*
+		* 			Storage holds raw memory: objects are only constructed and destroyed when the owner asks to, so unused
+		* 			objects are not constructed. Since only the owner knows which objects are constructed, it provides
+		* 			the used flags whenever storage might need to move objects (Flags is any type with operator[](size_t)).
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	T			Type of objects to store.
+		* \tparam	Allocator	Allocator to use for pages memory (rebound to T).
+		*/
+		template <typename T, typename Allocator = std::allocator<T> >
+		class ObjectsStorage
+		{
+		private:
+
+			// allocator types, rebound from the given allocator
+			typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> ObjectsAllocator;
+			typedef std::allocator_traits<ObjectsAllocator> ObjectsAllocatorTraits;
+			typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T*> PagesAllocator;
+
+			// should we manage memory with malloc / realloc / free instead of the allocator (only when the allocator is
+			// the default one, and objects can be moved bitwise)
+			typedef std::integral_constant<bool, IsTriviallyRelocatable<T>::value &&
+				std::is_same<ObjectsAllocator, std::allocator<T> >::value &&
+				alignof(T) <= alignof(std::max_align_t)> UseRealloc;
+
+			// allocator to use for pages memory
+			ObjectsAllocator _allocator;
+
+			// storage mode
+			StorageModes _mode;
+
+			// pages table. in contiguous mode there's only one page.
+			vector<T*, PagesAllocator> _pages;
+
+			// shift and mask to convert index into page and index in page.
+			size_t _page_shift;
+			size_t _page_mask;
+
+			// how many objects are currently constructed in storage.
+			size_t _size;
+
+			// how many objects we can hold without allocating more memory.
+			size_t _capacity;
+
+			// in virtual mode, size of the reserved address range and how much of it is committed.
+			size_t _reserved_bytes;
+			size_t _committed_bytes;
+
+			// in virtual mode, granularity of committing memory (page size or huge page size).
+			size_t _commit_granularity;
+
+			// in huge pages mode, true if we got explicit huge pages (and not just advised transparent huge pages).
+			bool _explicit_huge_pages;
+
+		public:
+
+			// true if objects can be moved with memcpy (see IsTriviallyRelocatable)
+			typedef std::integral_constant<bool, IsTriviallyRelocatable<T>::value> Relocatable;
+
+			/*!
+			 * \fn	ObjectsStorage::ObjectsStorage(StorageModes mode, size_t max_objects = 0, const Allocator& allocator = Allocator());
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	mode		Storage mode.
+			 * \param	max_objects	Max objects storage will hold. Required for STORAGE_VIRTUAL mode, which reserves
+			 * 						address space for all of them (if 0, will fall back to STORAGE_CONTIGUOUS).
+			 * \param	allocator	Allocator to use for pages memory (not used in STORAGE_VIRTUAL mode).
+			 */
+			ObjectsStorage(StorageModes mode, size_t max_objects = 0, const Allocator& allocator = Allocator());
+
+			/*!
+			 * \fn	ObjectsStorage::~ObjectsStorage();
+			 *
+			 * \brief	Destructor - free memory. Note: objects must be destroyed by the owner before.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			~ObjectsStorage();
+
+			// storage owns raw memory, so it can't be copied
+			ObjectsStorage(const ObjectsStorage&) = delete;
+			ObjectsStorage& operator=(const ObjectsStorage&) = delete;
+
+			/*!
+			 * \fn	inline T& ObjectsStorage::operator[](size_t index)
+			 *
+			 * \brief	Gets an object by index.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Object index.
+			 *
+			 * \return	The object.
+			 */
+			inline T& operator[](size_t index) { return _pages[index >> _page_shift][index & _page_mask]; }
+
+			/*!
+			 * \fn	inline const T& ObjectsStorage::operator[](size_t index) const
+			 *
+			 * \brief	Gets an object by index (const version).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Object index.
+			 *
+			 * \return	The object.
+			 */
+			inline const T& operator[](size_t index) const { return _pages[index >> _page_shift][index & _page_mask]; }
+
+			/*!
+			 * \fn	inline size_t ObjectsStorage::size() const
+			 *
+			 * \brief	Gets how many objects are in storage.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Objects count.
+			 */
+			inline size_t size() const { return _size; }
+
+			/*!
+			 * \fn	inline size_t ObjectsStorage::capacity() const
+			 *
+			 * \brief	Gets how many objects storage can hold without allocating more memory.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Storage capacity.
+			 */
+			inline size_t capacity() const { return _capacity; }
+
+			/*!
+			 * \fn	inline bool ObjectsStorage::is_contiguous() const
+			 *
+			 * \brief	Check if all objects are stored in a single contiguous memory block.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	True if storage is contiguous.
+			 */
+			inline bool is_contiguous() const { return _mode != STORAGE_PAGED; }
+
+			/*!
+			 * \fn	inline bool ObjectsStorage::is_virtual() const
+			 *
+			 * \brief	Check if storage is a reserved virtual memory range.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	True if storage is using STORAGE_VIRTUAL or STORAGE_VIRTUAL_HUGE_PAGES mode.
+			 */
+			inline bool is_virtual() const { return _mode == STORAGE_VIRTUAL || _mode == STORAGE_VIRTUAL_HUGE_PAGES; }
+
+			/*!
+			 * \fn	size_t ObjectsStorage::huge_pages_bytes() const
+			 *
+			 * \brief	Gets how many bytes of storage are actually backed by huge pages (queried from the OS).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Bytes backed by huge pages.
+			 */
+			inline size_t huge_pages_bytes() const { return _mode == STORAGE_VIRTUAL_HUGE_PAGES ? get_huge_pages_bytes(_pages[0], _reserved_bytes) : 0; }
+
+			/*!
+			 * \fn	bool ObjectsStorage::explicit_huge_pages() const
+			 *
+			 * \brief	Check if storage got explicit huge pages from the system's huge pages pool (MAP_HUGETLB), or only a
+			 * 			range advised to use transparent huge pages.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	True if storage is backed by explicit huge pages.
+			 */
+			inline bool explicit_huge_pages() const { return _explicit_huge_pages; }
+
+			/*!
+			 * \fn	inline T* ObjectsStorage::data()
+			 *
+			 * \brief	Gets pointer to the first object. Only meaningful for contiguous storage.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Pointer to first object, or NULL if storage is empty.
+			 */
+			inline T* data() { return _pages.size() ? _pages[0] : NULL; }
+
+			/*!
+			 * \fn	template <typename Flags> bool ObjectsStorage::extend(const Flags& is_used, size_t count = 1);
+			 *
+			 * \brief	Add new unconstructed objects at the end of storage.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	is_used	Which objects are currently constructed (in case we need to move them).
+			 * \param	count	How many objects to add.
+			 *
+			 * \return	True if storage had to move existing objects in memory to grow.
+			 */
+			template <typename Flags>
+			bool extend(const Flags& is_used, size_t count = 1);
+
+			/*!
+			 * \fn	template <typename Flags> bool ObjectsStorage::reserve(size_t amount, const Flags& is_used);
+			 *
+			 * \brief	Make sure storage can hold a given amount of objects without allocating more memory.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	amount	Objects count to reserve.
+			 * \param	is_used	Which objects are currently constructed (in case we need to move them).
+			 *
+			 * \return	True if storage had to move existing objects in memory to grow.
+			 */
+			template <typename Flags>
+			bool reserve(size_t amount, const Flags& is_used);
+
+			/*!
+			 * \fn	inline void ObjectsStorage::truncate(size_t new_size)
+			 *
+			 * \brief	Remove all objects from a given size to the end of storage (but keep memory).
+			 * 			Note: objects in removed range must already be destroyed.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	new_size	New storage size (must be smaller or equal to current size).
+			 */
+			inline void truncate(size_t new_size) { _size = new_size; }
+
+			/*!
+			 * \fn	inline void ObjectsStorage::clear()
+			 *
+			 * \brief	Remove all objects from storage (but keep memory).
+			 * 			Note: objects must already be destroyed.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			inline void clear() { truncate(0); }
+
+			/*!
+			 * \fn	template <typename... Args> inline void ObjectsStorage::construct(size_t index, Args&&... args)
+			 *
+			 * \brief	Construct an object in place.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Object index (must be smaller than size, and not constructed).
+			 * \param	args	Arguments to pass to object constructor.
+			 */
+			template <typename... Args>
+			inline void construct(size_t index, Args&&... args) { ObjectsAllocatorTraits::construct(_allocator, &(*this)[index], std::forward<Args>(args)...); }
+
+			/*!
+			 * \fn	inline void ObjectsStorage::destroy(size_t index)
+			 *
+			 * \brief	Destroy an object, but keep its memory.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Object index (must be constructed).
+			 */
+			inline void destroy(size_t index) { ObjectsAllocatorTraits::destroy(_allocator, &(*this)[index]); }
+
+			/*!
+			 * \fn	void ObjectsStorage::move_objects(size_t from, size_t to, size_t count);
+			 *
+			 * \brief	Move a range of constructed objects into a range of unconstructed objects. Objects in source range
+			 * 			are left destroyed. For relocatable types this is a single memmove per page.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	from	First object to move.
+			 * \param	to		First index to move objects into (ranges may only overlap if to is smaller than from).
+			 * \param	count	How many objects to move.
+			 */
+			void move_objects(size_t from, size_t to, size_t count);
+
+			/*!
+			 * \fn	template <typename Flags> size_t ObjectsStorage::release_unused_memory(size_t keep_capacity, bool& moved, const Flags& is_used);
+			 *
+			 * \brief	Return memory beyond the objects in storage to the system, while keeping a minimal capacity.
+			 * 			Contiguous storage reallocates into a smaller block, paged storage frees tail pages, and virtual
+			 * 			storage decommits its tail pages.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	keep_capacity	Capacity to keep (will never go below current size).
+			 * \param 	moved			Will be set to true if objects moved in memory.
+			 * \param	is_used			Which objects are currently constructed (in case we need to move them).
+			 *
+			 * \return	How many bytes were returned.
+			 */
+			template <typename Flags>
+			size_t release_unused_memory(size_t keep_capacity, bool& moved, const Flags& is_used);
+
+			/*!
+			 * \fn	template <typename Func> void ObjectsStorage::for_each_page(size_t begin, size_t end, Func func);
+			 *
+			 * \brief	Call a function for every contiguous block of objects in a given range.
+			 * 			In contiguous mode this is called once, in paged mode its called once per page.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	begin	First object index.
+			 * \param	end		Index to stop at (not included).
+			 * \param	func	Function to call with (T* objects, size_t first_index, size_t count). Return false to stop.
+			 */
+			template <typename Func>
+			inline void for_each_page(size_t begin, size_t end, Func func) const
+			{
+				while (begin < end)
+				{
+					size_t left_in_page = _page_mask - (begin & _page_mask);
+					size_t count = (end - begin - 1 < left_in_page ? end - begin - 1 : left_in_page) + 1;
+					if (!func(_pages[begin >> _page_shift] + (begin & _page_mask), begin, count))
+					{
+						return;
+					}
+					begin += count;
+				}
+			}
+
+		private:
+
+			/*!
+			 * \fn	template <typename Flags> bool ObjectsStorage::grow(size_t min_capacity, const Flags& is_used);
+			 *
+			 * \brief	Allocate more memory so storage can hold at least min_capacity objects.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	min_capacity	Minimal capacity to grow to.
+			 * \param	is_used			Which objects are currently constructed (in case we need to move them).
+			 *
+			 * \return	True if storage had to move existing objects in memory to grow.
+			 */
+			template <typename Flags>
+			bool grow(size_t min_capacity, const Flags& is_used);
+
+			/*!
+			 * \fn	template <typename Flags> bool ObjectsStorage::relocate(size_t new_capacity, const Flags& is_used);
+			 *
+			 * \brief	Move all objects into a new memory block (contiguous mode).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	new_capacity	New block capacity (if 0, will just free memory).
+			 * \param	is_used			Which objects are currently constructed.
+			 *
+			 * \return	True if any object was moved.
+			 */
+			template <typename Flags>
+			bool relocate(size_t new_capacity, const Flags& is_used);
+
+			// relocate() implementations: realloc the block, memcpy into a new block, or move objects one by one.
+			template <typename Flags>
+			bool relocate(size_t new_capacity, const Flags& is_used, std::true_type relocatable, std::true_type use_realloc);
+			template <typename Flags>
+			bool relocate(size_t new_capacity, const Flags& is_used, std::true_type relocatable, std::false_type use_realloc);
+			template <typename Flags>
+			bool relocate(size_t new_capacity, const Flags& is_used, std::false_type relocatable, std::false_type use_realloc);
+
+			// move a contiguous range of objects (memcpy or move constructor + destructor).
+			void move_range(T* dest, T* src, size_t count, std::true_type relocatable);
+			void move_range(T* dest, T* src, size_t count, std::false_type relocatable);
+
+			// allocate and free a block of objects memory (with malloc / free or via the allocator).
+			T* allocate_block(size_t count);
+			void deallocate_block(T* block, size_t count);
+
+			/*!
+			 * \fn	void ObjectsStorage::commit(size_t min_capacity);
+			 *
+			 * \brief	Commit more of the reserved address range so storage can hold at least min_capacity objects (virtual mode).
+			 * 			Will throw ExceededPoolLimit if exceeded the reserved range.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	min_capacity	Minimal capacity to commit.
+			 */
+			void commit(size_t min_capacity);
+		};
+	}
+}
+
+#include "_objects_storage_imp.h"
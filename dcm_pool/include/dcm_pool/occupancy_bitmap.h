@@ -0,0 +1,231 @@
+/*!
+* \file	include\dcm_pool\occupancy_bitmap.h.
+*
+* \brief		An internal bitmap of used indices in pool, that can skip unused indices a whole word at a time.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*! \brief	Word type used to store bits in the occupancy bitmap. */
+		typedef uint64_t BitmapWord;
+
+		/*! \brief	How many bits we have in every bitmap word. */
+		const size_t BitmapWordBits = 64;
+
+		/*! \brief	Get the index of the lowest set bit in a word (word must not be 0). */
+		inline size_t lowest_set_bit(BitmapWord word);
+
+		/*! \brief	Get the index of the highest set bit in a word (word must not be 0). */
+		inline size_t highest_set_bit(BitmapWord word);
+
+		/*!
+		* \class	OccupancyBitmap
+		*
+		* \brief	An internal bitmap that marks which indices in pool hold a live object.
+		* 			Works like a vector of bools, but can also find the next / previous used index by scanning 64 indices
+		* 			at a time with a single bit instruction. This lets us iterate sparse pools at the cost of live objects,
+		* 			and find the last used object without checking every hole before it.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Allocator	Allocator to use for the bitmap memory (rebound to the word type).
+		*/
+		template <typename Allocator = std::allocator<BitmapWord> >
+		class OccupancyBitmap
+		{
+		private:
+
+			// the bits, 64 indices per word. bits beyond size are always 0.
+			vector<BitmapWord, typename std::allocator_traits<Allocator>::template rebind_alloc<BitmapWord> > _words;
+
+			// how many indices we have.
+			size_t _size;
+
+		public:
+
+			/*!
+			 * \fn	OccupancyBitmap::OccupancyBitmap(const Allocator& allocator = Allocator())
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	allocator	Allocator to use for the bitmap memory.
+			 */
+			OccupancyBitmap(const Allocator& allocator = Allocator()) : _words(allocator), _size(0) { }
+
+			/*!
+			 * \fn	inline bool OccupancyBitmap::operator[](size_t index) const
+			 *
+			 * \brief	Check if an index is used.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Index to check.
+			 *
+			 * \return	True if used.
+			 */
+			inline bool operator[](size_t index) const { return (_words[index / BitmapWordBits] >> (index % BitmapWordBits)) & 1; }
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::set(size_t index)
+			 *
+			 * \brief	Mark an index as used.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Index to set.
+			 */
+			inline void set(size_t index) { _words[index / BitmapWordBits] |= BitmapWord(1) << (index % BitmapWordBits); }
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::reset(size_t index)
+			 *
+			 * \brief	Mark an index as unused.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Index to reset.
+			 */
+			inline void reset(size_t index) { _words[index / BitmapWordBits] &= ~(BitmapWord(1) << (index % BitmapWordBits)); }
+
+			/*!
+			 * \fn	inline size_t OccupancyBitmap::size() const
+			 *
+			 * \brief	Gets how many indices we have.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Bitmap size.
+			 */
+			inline size_t size() const { return _size; }
+
+			/*!
+			 * \fn	void OccupancyBitmap::resize(size_t size);
+			 *
+			 * \brief	Resize the bitmap. New indices are unused.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	size	New size.
+			 */
+			void resize(size_t size);
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::push_back(bool used)
+			 *
+			 * \brief	Add an index at the end of the bitmap.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	used	Is the new index used.
+			 */
+			inline void push_back(bool used) { resize(_size + 1); if (used) set(_size - 1); }
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::reserve(size_t amount)
+			 *
+			 * \brief	Reserve memory for indices.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	amount	How many indices to reserve.
+			 */
+			inline void reserve(size_t amount) { _words.reserve((amount + BitmapWordBits - 1) / BitmapWordBits); }
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::clear()
+			 *
+			 * \brief	Clears the bitmap.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			inline void clear() { _words.clear(); _size = 0; }
+
+			/*!
+			 * \fn	inline void OccupancyBitmap::shrink_to_fit()
+			 *
+			 * \brief	Free unused bitmap memory.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			inline void shrink_to_fit() { _words.shrink_to_fit(); }
+
+			/*!
+			 * \fn	size_t OccupancyBitmap::find_next(size_t from, size_t end) const;
+			 *
+			 * \brief	Find the first used index in range [from, end).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	from	First index to check.
+			 * \param	end		Index to stop at (must not be greater than size).
+			 *
+			 * \return	First used index, or end if there are none.
+			 */
+			size_t find_next(size_t from, size_t end) const;
+
+			/*!
+			 * \fn	size_t OccupancyBitmap::find_last(size_t from) const;
+			 *
+			 * \brief	Find the last used index, up to 'from' (inclusive).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	from	Index to start searching backwards from.
+			 *
+			 * \return	Last used index, or 0 if there are none.
+			 */
+			size_t find_last(size_t from) const;
+
+			/*!
+			 * \fn	template <typename Callback> bool OccupancyBitmap::for_each_used(size_t begin, size_t end, Callback callback) const;
+			 *
+			 * \brief	Call a callback for every used index in range [begin, end), in order.
+			 * 			Unused indices are skipped a whole word at a time.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	begin		First index.
+			 * \param	end			Index to stop at (must not be greater than size).
+			 * \param	callback	Callback to call with every used index. Return false to stop.
+			 *
+			 * \return	False if callback stopped the iteration.
+			 */
+			template <typename Callback>
+			bool for_each_used(size_t begin, size_t end, Callback callback) const;
+		};
+	}
+}
+
+#include "_occupancy_bitmap_imp.h"
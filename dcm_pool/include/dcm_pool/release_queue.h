@@ -0,0 +1,169 @@
+/*!
+* \file	include\dcm_pool\release_queue.h.
+*
+* \brief		A lock-free queue of objects to release, that any thread can push into.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	/*! \brief	How many ids every block of a release queue holds. */
+	const size_t ReleaseQueueBlockSize = 256;
+
+	/*!
+	* \class	ReleaseQueue
+	*
+	* \brief	A lock-free multi-producer, single-consumer queue of object ids.
+	* 			Any thread can Push() ids at any time, while only the thread that owns the pool drains them.
+	*
+	* 			Ids are stored in blocks of ReleaseQueueBlockSize ids. Producers claim a place in the last block with a
+	* 			single atomic increment, so there's no allocation per id (unlike a std::list). When a block is full,
+	* 			the producer that needs more room links a new block.
+	* 			Drained blocks are kept as a spare for the next time a block is needed, once no producer can still be
+	* 			using them, so in a steady state the queue doesn't allocate memory at all.
+	*
+	* 			Note: blocks are allocated with the global operator new, as pool allocators are not thread safe.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*/
+	class ReleaseQueue
+	{
+	private:
+
+		/*!
+		* \struct	Block
+		*
+		* \brief	A block of ids in queue.
+		*/
+		struct Block
+		{
+			// how many places producers claimed (may go beyond block size when block is full).
+			std::atomic<size_t> claimed;
+
+			// how many ids producers finished writing.
+			std::atomic<size_t> written;
+
+			// next block, or NULL if this is the last block.
+			std::atomic<Block*> next;
+
+			// consumer only: next retired block.
+			Block* retired_next;
+
+			// the ids.
+			ObjectId ids[ReleaseQueueBlockSize];
+
+			Block() : claimed(0), written(0), next(NULL), retired_next(NULL) { }
+		};
+
+		// block producers push into (NULL until first push).
+		std::atomic<Block*> _tail;
+
+		// first block ever created, so the consumer can find it.
+		std::atomic<Block*> _first;
+
+		// how many producers are pushing right now (blocks can only be reused when there are none).
+		std::atomic<size_t> _pushing;
+
+		// a drained block to reuse when producers need a new block.
+		std::atomic<Block*> _spare;
+
+		// consumer only: block to drain next, and how many ids of it were already drained.
+		Block* _head;
+		size_t _head_drained;
+
+		// consumer only: drained blocks waiting for no producers to be pushing, before they can be reused.
+		Block* _retired;
+
+	public:
+
+		/*!
+		 * \fn	ReleaseQueue::ReleaseQueue();
+		 *
+		 * \brief	Constructor. Doesn't allocate memory until the first push.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline ReleaseQueue();
+
+		/*!
+		 * \fn	ReleaseQueue::~ReleaseQueue();
+		 *
+		 * \brief	Destructor - free all blocks. No thread may push while the queue is destroyed.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline ~ReleaseQueue();
+
+		// queue owns its blocks, so it can't be copied
+		ReleaseQueue(const ReleaseQueue&) = delete;
+		ReleaseQueue& operator=(const ReleaseQueue&) = delete;
+
+		/*!
+		 * \fn	void ReleaseQueue::Push(ObjectId id);
+		 *
+		 * \brief	Add an id to the queue (thread safe, lock-free).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	Object id to add.
+		 */
+		inline void Push(ObjectId id);
+
+		/*!
+		 * \fn	template <typename Callback> size_t ReleaseQueue::Drain(Callback&& callback);
+		 *
+		 * \brief	Take all ids pushed so far, and call callback(id) for each of them (consumer thread only).
+		 * 			Ids pushed while draining may be left for the next drain.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	Callable that accepts an ObjectId.
+		 *
+		 * \return	How many ids were drained.
+		 */
+		template <typename Callback>
+		size_t Drain(Callback&& callback);
+
+	private:
+
+		/*!
+		 * \fn	Block* ReleaseQueue::NewBlock();
+		 *
+		 * \brief	Get a new empty block (the spare block if there is one).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	New block.
+		 */
+		inline Block* NewBlock();
+
+		/*!
+		 * \fn	void ReleaseQueue::ReuseRetiredBlocks();
+		 *
+		 * \brief	If no producer is pushing, keep one retired block as spare and free the rest (consumer thread only).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void ReuseRetiredBlocks();
+	};
+}
+
+#include "_release_queue_imp.h"
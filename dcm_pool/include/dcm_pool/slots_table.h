@@ -0,0 +1,190 @@
+/*!
+* \file	include\dcm_pool\slots_table.h.
+*
+* \brief		An internal table to convert object ids to their index in pool.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	SlotsTable
+		*
+		* \brief	An internal dense array used to convert object ids to their index in the pool's vector.
+		* 			Every object id is made of an index of a slot in this table and the slot generation. The slot holds the
+		* 			object's current index in the pool. This makes converting, assigning and updating ids O(1) array access,
+		* 			without any memory allocation per object.
+		* 			Released slots are reused for new objects, and while free they store the next free slot
+		* 			(the same trick used by the holes list), so no additional memory is wasted.
+		*
+		* 			Generations:
+		* 				Every slot has a generation counter that increase whenever the slot is allocated and whenever its released.
+		* 				This means used slots always have an odd generation, and ids of released objects never match their slot
+		* 				again, so stale ids are detected with a single compare.
+		* 				When a slot generation is about to wrap around (which with narrow ids can happen after a few reuses),
+		* 				the slot is retired instead of going back to the free list (it gets generation 0, which no id ever has).
+		* 				This way a stale id never becomes valid again, at the cost of losing a slot.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Allocator	Allocator to use for the slots memory (rebound to the slot type).
+		* \tparam	IdTraits	Ids width and layout (see IdTraits).
+		*/
+		template <typename Allocator = std::allocator<ObjectId>, typename IdTraits = DefaultIdTraits>
+		class SlotsTable
+		{
+		private:
+
+			/*!
+			* \struct	Slot
+			*
+			* \brief	A single slot in table.
+			*/
+			struct Slot
+			{
+				// for used slots this is object index in pool, for free slots this is the next free slot.
+				typename IdTraits::Id index;
+
+				// slot generation (odd = used, even = free).
+				typename IdTraits::Id generation;
+			};
+
+			// the slots.
+			vector<Slot, typename std::allocator_traits<Allocator>::template rebind_alloc<Slot> > _slots;
+
+			// first free slot to reuse, or IdTraits::InvalidIndex if there are no free slots.
+			size_t _first_free;
+
+			// how many slots are in the free slots list.
+			size_t _free_count;
+
+		public:
+
+			/*!
+			 * \fn	SlotsTable::SlotsTable(const Allocator& allocator = Allocator())
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	allocator	Allocator to use for the slots memory.
+			 */
+			SlotsTable(const Allocator& allocator = Allocator()) : _slots(allocator), _first_free(IdTraits::InvalidIndex), _free_count(0) { }
+
+			/*!
+			 * \fn	ObjectId SlotsTable::alloc(size_t index);
+			 *
+			 * \brief	Allocate a slot for a new object.
+			 * 			Will throw ExceededPoolLimit if there are no more slots to use.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	index	Index of the new object in pool.
+			 *
+			 * \return	The new object id.
+			 */
+			inline ObjectId alloc(size_t index);
+
+			/*!
+			 * \fn	inline size_t SlotsTable::available() const
+			 *
+			 * \brief	Get how many more slots can be allocated (free slots to reuse + new slots the ids can still represent).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	How many slots alloc() can still return without throwing.
+			 */
+			inline size_t available() const { return _free_count + (IdTraits::SlotMask - _slots.size()); }
+
+			/*!
+			 * \fn	void SlotsTable::release(ObjectId id);
+			 *
+			 * \brief	Release a slot so it can be reused by future objects (or retire it, if its generation is about to wrap).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to release. Must be a valid, used id.
+			 */
+			inline void release(ObjectId id);
+
+			/*!
+			 * \fn	inline bool SlotsTable::is_alive(ObjectId id) const
+			 *
+			 * \brief	Check if an id belongs to a currently used slot.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to check.
+			 *
+			 * \return	True if id is used and not stale.
+			 */
+			inline bool is_alive(ObjectId id) const
+			{
+				size_t slot = IdTraits::get_slot(id);
+				size_t generation = IdTraits::get_generation(id);
+				return slot < _slots.size() && _slots[slot].generation == generation && (generation & 1);
+			}
+
+			/*!
+			 * \fn	inline size_t SlotsTable::get_index(ObjectId id) const
+			 *
+			 * \brief	Gets the index in pool of a given object id.
+			 * 			Note: does not validate id, use is_alive() first if not sure.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id	Object id to get index for.
+			 *
+			 * \return	Object index in pool.
+			 */
+			inline size_t get_index(ObjectId id) const { return _slots[IdTraits::get_slot(id)].index; }
+
+			/*!
+			 * \fn	inline void SlotsTable::set_index(ObjectId id, size_t index)
+			 *
+			 * \brief	Update the index in pool of a given object id (used when objects move during defrag).
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	id		Object id to update.
+			 * \param	index	New object index in pool.
+			 */
+			inline void set_index(ObjectId id, size_t index) { _slots[IdTraits::get_slot(id)].index = (typename IdTraits::Id)index; }
+
+			/*!
+			 * \fn	void SlotsTable::clear();
+			 *
+			 * \brief	Clears the table and release all slots.
+			 * 			Note: keeps slots memory and generations, so ids from before clearing will not become valid again.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 */
+			inline void clear();
+		};
+	}
+}
+
+#include "_slots_table_imp.h"
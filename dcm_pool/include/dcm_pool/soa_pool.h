@@ -0,0 +1,553 @@
+/*!
+* \file	include\dcm_pool\soa_pool.h.
+*
+* \brief		Define the DcmSoaPool template class.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include "holes_list.h"
+#include "occupancy_bitmap.h"
+#include "slots_table.h"
+#include "defs.h"
+
+using namespace std;
+
+namespace dcm_pool
+{
+	/*!
+	 * \class	DcmSoaPool
+	 *
+	 * \brief	Dynamic, Contiguous-Memory, Structure-Of-Arrays objects pool.
+	 * 			Works just like DcmPool, but instead of storing whole objects it stores every field in its own contiguous
+	 * 			column. This means that iterating only some of the fields will only pull those fields through the cache,
+	 * 			instead of the entire object.
+	 *
+	 * 			For example, a pool of particles with position, velocity and color:
+	 * 				DcmSoaPool<Position, Velocity, Color> pool;
+	 * 			Updating positions will only need to read positions and velocities, and never touch colors.
+	 *
+	 * 			Notes:
+	 * 				- Alloc, Release, Defrag and defrag modes work exactly like in DcmPool.
+	 * 				- To access an object from the pool externally you need to use the DcmSoaPool::Ptr object and Get<Column>().
+	 * 				- Fields must have a default constructor, and the pool use their move assignment operator internally.
+	 * 				- Don't use bool fields, as vector<bool> is not contiguous memory (use char instead).
+	 * 				- The pool is not thread safe!
+	 *
+	 * \author	Ronen
+	 * \date	10/16/2026
+	 *
+	 * \tparam	Fields	Types of the fields (columns) every object in the pool has.
+	 */
+	template <typename... Fields>
+	class DcmSoaPool
+	{
+	public:
+
+		/*! \brief	Get the type of a given column. */
+		template <size_t Column>
+		using ColumnType = typename std::tuple_element<Column, std::tuple<Fields...> >::type;
+
+		/*!
+		 * \class	Ptr
+		 *
+		 * \brief	A pointer to an object inside this pool.
+		 * 			Caches the object index in columns, so accessing fields is direct as long as the pool wasn't defragged.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		class Ptr
+		{
+		private:
+
+			/*! \brief	The pool containing this object. */
+			DcmSoaPool<Fields...>* _pool;
+
+			/*! \brief	The object's unique id. */
+			ObjectId _id;
+
+			/*! \brief	Cached object index in columns. */
+			size_t _cached_index;
+
+			/*! \brief	Last pool version to indicate if cached index is still valid to use. */
+			unsigned int _pool_defrag_version;
+
+			/*! \brief	Pool releases count when we cached the index (if objects were released since, our object might be one of them). */
+			size_t _pool_releases_count;
+
+		public:
+
+			/*!
+			 * \fn	Ptr::Ptr(DcmSoaPool<Fields...>* pool, ObjectId id)
+			 *
+			 * \brief	Constructor
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	pool	The parent objects pool.
+			 * \param	id		Object's unique id in pool.
+			 */
+			Ptr(DcmSoaPool<Fields...>* pool = NULL, ObjectId id = ObjectPoolMaxIndex) :
+				_pool(pool), _id(id), _cached_index(ObjectPoolMaxIndex), _pool_defrag_version((unsigned int)-1), _pool_releases_count(0) {}
+
+			/*!
+			 * \fn	inline ObjectId Ptr::_get_id() const
+			 *
+			 * \brief	Gets the object id in pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	Return the object id.
+			 */
+			inline ObjectId _get_id() const { return _id; }
+
+			/*!
+			 * \fn	inline bool Ptr::IsAlive() const
+			 *
+			 * \brief	Check if the object this pointer points on is still alive in pool.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \return	True if object is alive, false if released or pointer is empty.
+			 */
+			inline bool IsAlive() const { return _pool && _pool->IsAlive(_id); }
+
+			/*!
+			 * \fn	template <size_t Column> ColumnType<Column>& Ptr::Get()
+			 *
+			 * \brief	Gets a field of the object.
+			 * 			Will throw AccessViolation if object was released.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \tparam	Column	Index of the field to get.
+			 *
+			 * \return	The field value.
+			 */
+			template <size_t Column>
+			ColumnType<Column>& Get();
+
+			/*!
+			 * \fn	inline bool Ptr::operator==(const Ptr& other) const
+			 *
+			 * \brief	Equality operator.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	other	The other pointer to compare to.
+			 *
+			 * \return	True if the parameters are considered equivalent.
+			 */
+			inline bool operator==(const Ptr& other) const { return _id == other._id && _pool == other._pool; }
+
+			/*!
+			 * \fn	inline bool Ptr::operator!=(const Ptr& other) const
+			 *
+			 * \brief	Inequality operator.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param	other	The other pointer to compare to.
+			 *
+			 * \return	True if the parameters are not considered equivalent.
+			 */
+			inline bool operator!=(const Ptr& other) const { return !(*this == other); }
+
+			/*!
+			 * \fn	inline void Ptr::_set_cached_index(size_t index, unsigned int defrag_version, size_t releases_count)
+			 *
+			 * \brief	Sets cached index, defrag version and releases count.
+			 *
+			 * \author	Ronen
+			 * \date	10/16/2026
+			 *
+			 * \param 	index			Object index in columns.
+			 * \param 	defrag_version	The pool's defrag version.
+			 * \param 	releases_count	The pool's releases count.
+			 */
+			inline void _set_cached_index(size_t index, unsigned int defrag_version, size_t releases_count) {
+				_cached_index = index;
+				_pool_defrag_version = defrag_version;
+				_pool_releases_count = releases_count;
+			}
+		};
+
+		/*! \brief	Callback to invoke on every new object you allocate. */
+		SoaEventsHandler<Fields...> OnAlloc = NULL;
+
+		/*! \brief	Callback to invoke on every object you release. */
+		SoaEventsHandler<Fields...> OnRelease = NULL;
+
+	private:
+
+		/*! \brief	The pooled objects fields, every field in its own vector. */
+		std::tuple<vector<Fields>...> _columns;
+
+		/*! \brief	Object id for every index in columns (for holes this is used to store the holes list). */
+		vector<ObjectId> _ids;
+
+		/*! \brief	Is the object in every index in columns currently used (bitmap, so finding used objects can skip holes a word at a time). */
+		_internal::OccupancyBitmap<> _is_used;
+
+		/*! \brief	Convert unique object id to its index in columns. */
+		_internal::SlotsTable<> _slots;
+
+		// holes inside the pool
+		_internal::HolesList<vector<ObjectId> > _holes;
+
+		/*! \brief	Max objects count in pool. */
+		size_t _max_size;
+
+		/*! \brief	Current pool actual size (allocated objects). */
+		size_t _allocated_objects_count;
+
+		/*! \brief	Highest index we actually use in the columns (remember that there could be holes if not defragged). */
+		size_t _max_used_index_in_vector;
+
+		/*! \brief	Required diff between actually used objects and columns size to make us resize the columns. */
+		size_t _shrink_pool_threshold;
+
+		/*! \brief	How to handle defragging. */
+		DefragModes _defrag_mode;
+
+		/*! \brief	How many times was this pool defragged? */
+		unsigned int _defrags_count;
+
+		/*! \brief	How many times were objects released (or the pool cleared)? tells pointers if their cached index might be stale. */
+		size_t _releases_count;
+
+		/*! \brief	In DEFRAG_STABLE mode, index of the first hole (or ObjectPoolMaxIndex if there are no holes). */
+		size_t _first_hole;
+
+	public:
+
+		/*!
+		 * \fn	DcmSoaPool::DcmSoaPool(size_t max_size, size_t reserve, size_t shrink_threshold, DefragModes defrag_mode);
+		 *
+		 * \brief	Constructor
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	max_size			Maximum objects count in pool. Set to 0 for unlimited count.
+		 * \param	reserve				How many objects to reserve in the pool memory (using vectors reserve).
+		 * \param	shrink_threshold	When to shrink the columns down, if objects are released.
+		 * \param	defrag_mode			How to handle defragging.
+		 */
+		DcmSoaPool(size_t max_size = 0, size_t reserve = 0, size_t shrink_threshold = 1024, DefragModes defrag_mode = DEFRAG_DEFERRED);
+
+		/*!
+		 * \fn	Ptr DcmSoaPool::Alloc();
+		 *
+		 * \brief	Allocate an object from the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	A Ptr pointing at the newly-allocated object.
+		 */
+		Ptr Alloc();
+
+		/*!
+		 * \fn	void DcmSoaPool::Release(Ptr obj);
+		 *
+		 * \brief	Releases the given object and return it to the pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	obj		Object to release.
+		 */
+		void Release(Ptr obj);
+
+		/*!
+		 * \fn	void DcmSoaPool::Release(ObjectId id);
+		 *
+		 * \brief	Releases the given object and return it to the pool.
+		 * 			Will throw AccessViolation if id is not a used object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id		Object to release.
+		 */
+		void Release(ObjectId id);
+
+		/*!
+		 * \fn	bool DcmSoaPool::TryRelease(ObjectId id);
+		 *
+		 * \brief	Releases the given object if its alive, without throwing exceptions for stale or invalid ids.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id		Object to release.
+		 *
+		 * \return	True if object was released, false if id is not a used object.
+		 */
+		bool TryRelease(ObjectId id);
+
+		/*!
+		 * \fn	bool DcmSoaPool::IsAlive(ObjectId id) const;
+		 *
+		 * \brief	Check if an object id belongs to a currently used object in pool.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id		Object id to check.
+		 *
+		 * \return	True if object is alive, false otherwise.
+		 */
+		bool IsAlive(ObjectId id) const;
+
+		/*!
+		 * \fn	template <size_t Column> ColumnType<Column>& DcmSoaPool::Get(ObjectId id);
+		 *
+		 * \brief	Gets a field of an object from id.
+		 * 			Will throw AccessViolation if id is not a used object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \tparam	Column	Index of the field to get.
+		 * \param	id		Object id to get field from.
+		 *
+		 * \return	The field value.
+		 */
+		template <size_t Column>
+		ColumnType<Column>& Get(ObjectId id);
+
+		/*!
+		 * \fn	template <size_t Column> ColumnType<Column>* DcmSoaPool::TryGet(ObjectId id);
+		 *
+		 * \brief	Gets a field of an object from id, without throwing exceptions for stale or invalid ids.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \tparam	Column	Index of the field to get.
+		 * \param	id		Object id to get field from.
+		 *
+		 * \return	Pointer to the field value, or NULL if id is not a used object.
+		 */
+		template <size_t Column>
+		ColumnType<Column>* TryGet(ObjectId id);
+
+		/*!
+		 * \fn	void DcmSoaPool::Reserve(size_t amount);
+		 *
+		 * \brief	Reserves the given amount in all the internal columns.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	amount	The amount of objects to reserve.
+		 */
+		void Reserve(size_t amount);
+
+		/*!
+		 * \fn	void DcmSoaPool::Iterate(SoaPoolIterator<Fields...> callback);
+		 *
+		 * \brief	Iterates all the objects in pool with all their fields.
+		 * 			Note: if working in deferred defrag mode, this will trigger defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	callback	The callback to use on the objects while iterating.
+		 */
+		void Iterate(SoaPoolIterator<Fields...> callback);
+
+		/*!
+		 * \fn	template <size_t... Columns, typename Callback> void DcmSoaPool::IterateColumns(Callback callback);
+		 *
+		 * \brief	Iterates all the objects in pool, but only with the given columns.
+		 * 			Only the requested columns are read, so this is much more cache-friendly than iterating all fields.
+		 * 			Note: if working in deferred defrag mode, this will trigger defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \tparam	Columns		Indices of the fields to iterate.
+		 * \tparam	Callback	Callback type, must accept (ColumnType<Columns>&..., ObjectId).
+		 * \param	callback	The callback to use on the objects while iterating.
+		 */
+		template <size_t... Columns, typename Callback>
+		void IterateColumns(Callback callback);
+
+		/*!
+		 * \fn	template <size_t Column> ColumnType<Column>* DcmSoaPool::GetColumn();
+		 *
+		 * \brief	Gets direct access to a column's contiguous memory.
+		 * 			Valid range is [0, size()) only if the pool is defragged (call Defrag() first if not sure), and
+		 * 			the pointer is only valid until the next allocation or defrag.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \tparam	Column	Index of the column to get.
+		 *
+		 * \return	Pointer to the first value in column.
+		 */
+		template <size_t Column>
+		ColumnType<Column>* GetColumn();
+
+		/*!
+		 * \fn	void DcmSoaPool::Clear();
+		 *
+		 * \brief	Clears the entire pool, making all objects in it free.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void Clear();
+
+		/*!
+		 * \fn	inline size_t DcmSoaPool::size() const;
+		 *
+		 * \brief	Gets the size of the pool, eg allocated objects count.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Pool size.
+		 */
+		inline size_t size() const { return _allocated_objects_count; }
+
+		/*!
+		 * \fn	void DcmSoaPool::ClearUnusedMemory();
+		 *
+		 * \brief	Force the pool to clear unused memory now.
+		 * 			This process happens automatically as you release objects, based on shrink_threshold.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void ClearUnusedMemory();
+
+		/*!
+		 * \fn	void DcmSoaPool::Defrag();
+		 *
+		 * \brief	Defrags the pool to make the columns continuous.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void Defrag();
+
+		/*!
+		 * \fn	inline unsigned int DcmSoaPool::_get_defrags_count() const
+		 *
+		 * \brief	Gets defrags count.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	The defrags count.
+		 */
+		inline unsigned int _get_defrags_count() const { return _defrags_count; }
+
+		/*!
+		 * \fn	inline size_t DcmSoaPool::_get_releases_count() const
+		 *
+		 * \brief	Gets how many times objects were released (or the pool cleared).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	The releases count.
+		 */
+		inline size_t _get_releases_count() const { return _releases_count; }
+
+		/*!
+		 * \fn	size_t DcmSoaPool::_get_index(ObjectId id) const;
+		 *
+		 * \brief	Convert object id to its index in columns.
+		 * 			Will throw AccessViolation if id does not belong to a used object.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	id	Object id to get index for.
+		 *
+		 * \return	Object index in columns.
+		 */
+		size_t _get_index(ObjectId id) const;
+
+	private:
+
+		/*!
+		 * \fn	Ptr DcmSoaPool::AssignObject(size_t index);
+		 *
+		 * \brief	Assign an object in the pool (internally) and return its object pointer.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Zero-based index of the object in pool.
+		 *
+		 * \return	New object pointer.
+		 */
+		Ptr AssignObject(size_t index);
+
+		/*!
+		 * \fn	void DcmSoaPool::ReleaseAt(size_t index, ObjectId id);
+		 *
+		 * \brief	Release an object we already validated and know its index.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	index	Object index in columns.
+		 * \param	id		Object id.
+		 */
+		void ReleaseAt(size_t index, ObjectId id);
+
+		/*!
+		 * \fn	void DcmSoaPool::CompactStable();
+		 *
+		 * \brief	Close all holes while keeping objects order (used in DEFRAG_STABLE mode).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		void CompactStable();
+
+		// per-column helpers, applied to all columns via index sequence
+		template <size_t... I>
+		void IterateAllColumns(SoaPoolIterator<Fields...> callback, std::index_sequence<I...>);
+
+		template <size_t... I>
+		void GrowColumns(std::index_sequence<I...>);
+
+		template <size_t... I>
+		void ResizeColumns(size_t new_size, std::index_sequence<I...>);
+
+		template <size_t... I>
+		void ReserveColumns(size_t amount, std::index_sequence<I...>);
+
+		template <size_t... I>
+		void ClearColumns(std::index_sequence<I...>);
+
+		template <size_t... I>
+		void MoveObject(size_t from, size_t to, std::index_sequence<I...>);
+	};
+}
+
+// include implementation
+#include "_soa_pool_imp.h"
@@ -0,0 +1,357 @@
+/*!
+* \file	include\dcm_pool\systems_scheduler.h.
+*
+* \brief		A scheduler that runs the update systems of many pools concurrently, based on their dependencies.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <initializer_list>
+#include "thread_pool.h"
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*!
+		* \class	ISchedulerSystem
+		*
+		* \brief	Interface of a system in the scheduler, eg a pool and a callback to run on all its objects.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*/
+		class ISchedulerSystem
+		{
+		public:
+			virtual ~ISchedulerSystem() { }
+
+			/*! \brief	Prepare pool for iteration (may defrag) and return how many chunks to run. */
+			virtual size_t prepare(size_t threads_count) = 0;
+
+			/*! \brief	Run a single chunk. Return false if callback returned ITER_BREAK. */
+			virtual bool run_chunk(size_t chunk) = 0;
+		};
+
+		/*!
+		* \class	PoolSystem
+		*
+		* \brief	A scheduler system that runs a callback on all the objects of a DcmPool.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*
+		* \tparam	Pool		Pool type.
+		* \tparam	Callback	Callback type (same signatures as DcmPool::ForEach()).
+		*/
+		template <typename Pool, typename Callback>
+		class PoolSystem : public ISchedulerSystem
+		{
+		private:
+
+			// pool to iterate and callback to run.
+			Pool& _pool;
+			Callback _callback;
+
+			// requested and actual chunk size.
+			size_t _requested_grain;
+			size_t _grain;
+
+		public:
+
+			PoolSystem(Pool& pool, const Callback& callback, size_t grain) : _pool(pool), _callback(callback), _requested_grain(grain), _grain(grain) { }
+
+			virtual size_t prepare(size_t threads_count) { _grain = _requested_grain; return _pool._prepare_chunks(_grain, threads_count); }
+
+			virtual bool run_chunk(size_t chunk) { return _pool._iterate_chunk(_callback, chunk, _grain); }
+		};
+
+		/*!
+		* \struct	SchedulerTask
+		*
+		* \brief	A single task in the scheduler, eg a chunk of a system.
+		*/
+		struct SchedulerTask
+		{
+			size_t system;
+			size_t chunk;
+		};
+
+		/*!
+		* \class	WorkStealingQueue
+		*
+		* \brief	Per-worker tasks queue. The owner pushes and pops tasks from the back (so it keeps working on what it
+		* 			just created while its still in cache), and other workers steal from the front when they run out of work.
+		* 			Every queue has its own lock: tasks are whole chunks of a pool, so queues are touched rarely compared to the
+		* 			work they hold, and a lock per queue only makes workers wait when they actually pick from the same queue.
+		*
+		* \author	Ronen
+		* \date	10/16/2026
+		*/
+		class WorkStealingQueue
+		{
+		private:
+
+			std::mutex _mutex;
+			std::deque<SchedulerTask> _tasks;
+
+		public:
+
+			/*! \brief	Push a task (owner only). */
+			inline void push(const SchedulerTask& task) { std::lock_guard<std::mutex> lock(_mutex); _tasks.push_back(task); }
+
+			/*! \brief	Pop the newest task (owner only). Returns false if empty. */
+			inline bool pop(SchedulerTask& task)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_tasks.empty()) return false;
+				task = _tasks.back();
+				_tasks.pop_back();
+				return true;
+			}
+
+			/*! \brief	Steal the oldest task (other workers). Returns false if empty. */
+			inline bool steal(SchedulerTask& task)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_tasks.empty()) return false;
+				task = _tasks.front();
+				_tasks.pop_front();
+				return true;
+			}
+
+			/*! \brief	Remove all tasks. */
+			inline void clear() { std::lock_guard<std::mutex> lock(_mutex); _tasks.clear(); }
+		};
+	}
+
+	/*!
+	* \class	SystemsScheduler
+	*
+	* \brief	Runs update systems of many pools concurrently, using all threads of a thread pool.
+	* 			A system is a pool + a callback to run on all its objects, + the resources it reads and writes (other pools,
+	* 			or any other shared object, identified by its address). A system always writes its own pool.
+	* 			Systems that touch the same resource, and at least one of them writes it, run in the order they were added.
+	* 			All other systems can run at the same time.
+	*
+	* 			Every system is split into chunks (like DcmPool::ParallelIterate()), and chunks of all ready systems are spread
+	* 			over the workers, each with its own tasks queue. Workers that run out of tasks steal from others, so small and
+	* 			big pools share the cores, instead of every pool being parallelized (or not) on its own.
+	*
+	* 			Usage example:
+	* 				SystemsScheduler scheduler;
+	* 				scheduler.AddSystem(velocities, [](Velocity& v) { v.apply_gravity(); });
+	* 				scheduler.AddSystem(positions, [&](Position& p) { p.move(velocities); }, { &velocities });
+	* 				scheduler.AddSystem(sprites, [](Sprite& s) { s.animate(); });
+	* 				scheduler.Run();	// call every frame
+	*
+	* 			Note: callbacks run concurrently, so they must be thread safe. Don't allocate or release objects in pools
+	* 			while the scheduler runs.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*/
+	class SystemsScheduler
+	{
+	private:
+
+		/*!
+		* \struct	SystemState
+		*
+		* \brief	A registered system and its dependencies.
+		*/
+		struct SystemState
+		{
+			// the system itself.
+			std::unique_ptr<_internal::ISchedulerSystem> system;
+
+			// resources this system reads and writes (including its own pool).
+			vector<const void*> reads;
+			vector<const void*> writes;
+
+			// systems that must wait for this system to finish.
+			vector<size_t> dependents;
+
+			// how many systems this system waits for.
+			size_t dependencies_count;
+
+			// state while running: dependencies not done yet, chunks not done yet, and did callback break.
+			std::atomic<size_t> pending_dependencies;
+			std::atomic<size_t> pending_chunks;
+			std::atomic<bool> stopped;
+		};
+
+		// thread pool to run on.
+		ThreadPool& _workers;
+
+		// registered systems, in the order they were added.
+		vector<std::unique_ptr<SystemState> > _systems;
+
+		// tasks queue per worker.
+		vector<std::unique_ptr<_internal::WorkStealingQueue> > _queues;
+
+		// how many systems didn't finish yet in current run.
+		std::atomic<size_t> _pending_systems;
+
+		// set if a callback threw, to stop all workers.
+		std::atomic<bool> _abort;
+
+		// idle workers sleep on this condition until new tasks are queued, all systems are done, or a callback threw.
+		std::mutex _idle_mutex;
+		std::condition_variable _idle_condition;
+
+		// how many workers sleep on the idle condition (guarded by _idle_mutex).
+		size_t _idle_workers;
+
+		// increased (under _idle_mutex) whenever new tasks are queued, so idle workers know they have something to steal.
+		std::atomic<size_t> _tasks_version;
+
+	public:
+
+		/*!
+		 * \fn	SystemsScheduler::SystemsScheduler(ThreadPool& workers = ThreadPool::Default());
+		 *
+		 * \brief	Constructor.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	workers	Thread pool to run systems on. Defaults to the library's default thread pool.
+		 */
+		inline SystemsScheduler(ThreadPool& workers = ThreadPool::Default());
+
+		/*!
+		 * \fn	template <typename Pool, typename Callback> size_t SystemsScheduler::AddSystem(Pool& pool, const Callback& callback, std::initializer_list<const void*> reads = {}, std::initializer_list<const void*> writes = {}, size_t grain = 0);
+		 *
+		 * \brief	Register a new system.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	pool		Pool to iterate (the system writes it).
+		 * \param	callback	Callback to run on all objects in pool (same signatures as DcmPool::ForEach()).
+		 * 						Returning ITER_BREAK stops remaining chunks of this system.
+		 * \param	reads		Resources the callback reads (for example other pools it accesses).
+		 * \param	writes		Resources the callback writes, other than its own pool.
+		 * \param	grain		Objects per chunk (0 to pick automatically).
+		 *
+		 * \return	System index.
+		 */
+		template <typename Pool, typename Callback>
+		size_t AddSystem(Pool& pool, const Callback& callback, std::initializer_list<const void*> reads = {}, std::initializer_list<const void*> writes = {}, size_t grain = 0);
+
+		/*!
+		 * \fn	void SystemsScheduler::Run();
+		 *
+		 * \brief	Run all systems once, and wait for them to finish.
+		 * 			If a callback throws, remaining work is skipped and the exception is rethrown here.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void Run();
+
+		/*!
+		 * \fn	inline size_t SystemsScheduler::size() const
+		 *
+		 * \brief	Gets how many systems are registered.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Systems count.
+		 */
+		inline size_t size() const { return _systems.size(); }
+
+		/*!
+		 * \fn	inline void SystemsScheduler::Clear()
+		 *
+		 * \brief	Remove all systems.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void Clear() { _systems.clear(); }
+
+	private:
+
+		/*!
+		 * \fn	void SystemsScheduler::StartSystem(size_t system, size_t worker);
+		 *
+		 * \brief	Start a system whose dependencies are done: prepare its pool and queue its chunks.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	system	System index.
+		 * \param	worker	Worker to queue chunks on.
+		 */
+		inline void StartSystem(size_t system, size_t worker);
+
+		/*!
+		 * \fn	void SystemsScheduler::FinishSystem(size_t system, size_t worker);
+		 *
+		 * \brief	Mark a system as done, and start the systems waiting for it.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	system	System index.
+		 * \param	worker	Worker to queue chunks of started systems on.
+		 */
+		inline void FinishSystem(size_t system, size_t worker);
+
+		/*!
+		 * \fn	void SystemsScheduler::WorkerLoop(size_t worker);
+		 *
+		 * \brief	Run tasks from worker's queue (or steal from others) until all systems are done.
+		 * 			When there are no tasks to run, sleeps until new tasks are queued.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	worker	Worker index.
+		 */
+		inline void WorkerLoop(size_t worker);
+
+		/*!
+		 * \fn	void SystemsScheduler::WakeIdleWorkers(bool new_tasks);
+		 *
+		 * \brief	Wake up workers sleeping in WorkerLoop().
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	new_tasks	True if woken because new tasks were queued.
+		 */
+		inline void WakeIdleWorkers(bool new_tasks);
+
+		/*!
+		 * \fn	static bool SystemsScheduler::Conflicts(const SystemState& first, const SystemState& second);
+		 *
+		 * \brief	Check if two systems touch the same resource, and at least one of them writes it.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	True if systems can't run at the same time.
+		 */
+		static inline bool Conflicts(const SystemState& first, const SystemState& second);
+	};
+}
+
+#include "_systems_scheduler_imp.h"
@@ -0,0 +1,195 @@
+/*!
+* \file	include\dcm_pool\thread_pool.h.
+*
+* \brief		A persistent pool of worker threads, used to iterate pools in parallel.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include "defs.h"
+
+
+using namespace std;
+
+namespace dcm_pool
+{
+	/*!
+	* \class	ThreadPool
+	*
+	* \brief	A persistent pool of worker threads that runs batches of tasks in parallel.
+	* 			Workers are created once and sleep while there's no work, so running a batch every frame doesn't create threads.
+	* 			The calling thread also runs tasks, so a pool of N threads uses N - 1 workers.
+	*
+	* 			Usage example:
+	* 				ThreadPool workers(4);
+	* 				workers.ParallelFor(100, [&](size_t task) { process(task); });
+	*
+	* 			Note: only one batch runs at a time. If a task starts another batch (on any thread pool), the inner batch runs
+	* 			on the task's thread without workers.
+	*
+	* \author	Ronen
+	* \date	10/16/2026
+	*/
+	class ThreadPool
+	{
+	private:
+
+		// worker threads.
+		vector<std::thread> _workers;
+
+		// protects batch state and wakes up workers.
+		std::mutex _mutex;
+		std::condition_variable _wake_workers;
+		std::condition_variable _batch_done;
+
+		// only one batch can run at a time.
+		std::mutex _batch_mutex;
+
+		// current batch: task function, its context, and how many tasks we have.
+		void(*_task)(void*, size_t);
+		void* _task_context;
+		size_t _tasks_count;
+
+		// next task to take, and how many workers are still working on current batch.
+		std::atomic<size_t> _next_task;
+		size_t _busy_workers;
+
+		// increased on every batch, so workers know they have new work.
+		size_t _batch_id;
+
+		// first exception thrown by a task in current batch.
+		std::exception_ptr _exception;
+
+		// set to stop the workers.
+		bool _stop;
+
+	public:
+
+		/*!
+		 * \fn	ThreadPool::ThreadPool(size_t threads_count = 0);
+		 *
+		 * \brief	Constructor. Creates the worker threads.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	threads_count	How many threads will run tasks, including the calling thread.
+		 * 							0 to use the number of hardware threads.
+		 */
+		inline ThreadPool(size_t threads_count = 0);
+
+		/*!
+		 * \fn	ThreadPool::~ThreadPool();
+		 *
+		 * \brief	Destructor. Stops and joins the worker threads.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline ~ThreadPool();
+
+		// no copying
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/*!
+		 * \fn	inline size_t ThreadPool::size() const
+		 *
+		 * \brief	Gets how many threads run tasks, including the calling thread.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Threads count.
+		 */
+		inline size_t size() const { return _workers.size() + 1; }
+
+		/*!
+		 * \fn	template <typename Callback> void ThreadPool::ParallelFor(size_t tasks_count, Callback&& callback);
+		 *
+		 * \brief	Run callback(task) for every task in [0, tasks_count), spread over all threads, and wait until all are done.
+		 * 			If a task throws, remaining tasks are skipped and the first exception is rethrown on the calling thread.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	tasks_count	How many tasks to run.
+		 * \param	callback	Callable that accepts a task index.
+		 */
+		template <typename Callback>
+		void ParallelFor(size_t tasks_count, Callback&& callback);
+
+		/*!
+		 * \fn	static ThreadPool& ThreadPool::Default();
+		 *
+		 * \brief	Gets the library's default thread pool, which uses all the hardware threads.
+		 * 			Created the first time it's used.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Default thread pool.
+		 */
+		static inline ThreadPool& Default();
+
+	private:
+
+		/*!
+		 * \fn	void ThreadPool::Run(size_t tasks_count, void(*task)(void*, size_t), void* context);
+		 *
+		 * \brief	Run a batch of tasks on all threads and wait for it to finish.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	tasks_count	How many tasks to run.
+		 * \param	task		Function to run every task with.
+		 * \param	context		Context to pass to task function.
+		 */
+		inline void Run(size_t tasks_count, void(*task)(void*, size_t), void* context);
+
+		/*!
+		 * \fn	void ThreadPool::RunTasks();
+		 *
+		 * \brief	Take and run tasks from current batch until there are no more tasks.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void RunTasks();
+
+		/*!
+		 * \fn	void ThreadPool::WorkerLoop();
+		 *
+		 * \brief	Worker threads main loop: wait for a batch, run tasks, repeat until stopped.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 */
+		inline void WorkerLoop();
+
+		/*!
+		 * \fn	static bool& ThreadPool::InsideTask();
+		 *
+		 * \brief	Is the current thread running a task right now (used to run nested batches inline).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Reference to thread-local flag.
+		 */
+		static inline bool& InsideTask();
+	};
+}
+
+#include "_thread_pool_imp.h"
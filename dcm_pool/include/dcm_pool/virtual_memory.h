@@ -0,0 +1,128 @@
+/*!
+* \file	include\dcm_pool\virtual_memory.h.
+*
+* \brief		Internal helpers to reserve and commit virtual memory.
+* \license		MIT
+* \autor		Ronen Ness.
+* \since		2018
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include "defs.h"
+
+
+namespace dcm_pool
+{
+	namespace _internal
+	{
+		/*! \brief	Huge pages size we align to when using huge pages (the common 2MB huge page). */
+		const size_t HugePageSize = 2 * 1024 * 1024;
+
+		/*!
+		 * \fn	size_t get_virtual_page_size();
+		 *
+		 * \brief	Gets the OS virtual memory page size (the granularity of committing memory).
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \return	Page size in bytes.
+		 */
+		inline size_t get_virtual_page_size();
+
+		/*!
+		 * \fn	void* reserve_virtual_memory(size_t bytes);
+		 *
+		 * \brief	Reserve a range of address space without committing any physical memory to it.
+		 * 			Will throw std::bad_alloc if failed.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	bytes	How many bytes to reserve (must be a multiple of page size).
+		 *
+		 * \return	Start of the reserved range.
+		 */
+		inline void* reserve_virtual_memory(size_t bytes);
+
+		/*!
+		 * \fn	void* reserve_huge_pages_memory(size_t bytes, bool& explicit_huge_pages);
+		 *
+		 * \brief	Reserve a range of address space that will be backed by huge pages when committed.
+		 * 			Will first try to get explicit huge pages from the system's huge pages pool (MAP_HUGETLB), and if not
+		 * 			available will reserve a regular range aligned to huge page size and advise transparent huge pages.
+		 * 			Will throw std::bad_alloc if failed.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	bytes				How many bytes to reserve (must be a multiple of HugePageSize).
+		 * \param 	explicit_huge_pages	Will be set to true if got explicit huge pages.
+		 *
+		 * \return	Start of the reserved range.
+		 */
+		inline void* reserve_huge_pages_memory(size_t bytes, bool& explicit_huge_pages);
+
+		/*!
+		 * \fn	size_t get_huge_pages_bytes(void* address, size_t bytes);
+		 *
+		 * \brief	Query the OS for how many bytes of a reserved range are actually backed by huge pages.
+		 * 			Only supported on Linux (reads /proc/self/smaps, so don't call it every frame). Returns 0 elsewhere.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	address	Start of the reserved range.
+		 * \param	bytes	Size of the reserved range.
+		 *
+		 * \return	Bytes backed by huge pages.
+		 */
+		inline size_t get_huge_pages_bytes(void* address, size_t bytes);
+
+		/*!
+		 * \fn	void commit_virtual_memory(void* address, size_t bytes);
+		 *
+		 * \brief	Make a part of a reserved range readable and writable.
+		 * 			Will throw std::bad_alloc if failed.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	address	Start of the range to commit (must be page aligned).
+		 * \param	bytes	How many bytes to commit (must be a multiple of page size).
+		 */
+		inline void commit_virtual_memory(void* address, size_t bytes);
+
+		/*!
+		 * \fn	void decommit_virtual_memory(void* address, size_t bytes);
+		 *
+		 * \brief	Return the physical memory of a part of a reserved range to the system, but keep it reserved.
+		 * 			The range must be committed again before using it.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	address	Start of the range to decommit (must be page aligned).
+		 * \param	bytes	How many bytes to decommit (must be a multiple of page size).
+		 */
+		inline void decommit_virtual_memory(void* address, size_t bytes);
+
+		/*!
+		 * \fn	void release_virtual_memory(void* address, size_t bytes);
+		 *
+		 * \brief	Release a whole reserved range, including its committed memory.
+		 *
+		 * \author	Ronen
+		 * \date	10/16/2026
+		 *
+		 * \param	address	Start of the reserved range.
+		 * \param	bytes	Size of the reserved range.
+		 */
+		inline void release_virtual_memory(void* address, size_t bytes);
+	}
+}
+
+#include "_virtual_memory_imp.h"